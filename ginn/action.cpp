@@ -20,8 +20,10 @@
  */
 #include "ginn/action.h"
 
+#include <algorithm>
 #include "ginn/actionbuilder.h"
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <string>
 #include <utility>
@@ -60,6 +62,49 @@ end() const
 }
 
 
+bool
+operator==(Action const& lhs, Action const& rhs)
+{
+  return std::distance(std::begin(lhs), std::end(lhs))
+      == std::distance(std::begin(rhs), std::end(rhs))
+      && std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs),
+                    [](Action::Event const& l, Action::Event const& r) -> bool
+                    { return l.type == r.type && l.code == r.code && l.keysym == r.keysym; });
+}
+
+
+bool Action::
+resolve(Keymap const& keymap, Keymap::KeysymList const& changed)
+{
+  bool is_changed = false;
+  for (auto& event: events_)
+  {
+    if (event.keysym != Keymap::no_symbol
+     && std::binary_search(std::begin(changed), std::end(changed), event.keysym))
+    {
+      Keymap::Keycode code = keymap.to_keycode(event.keysym);
+      if (code != event.code)
+      {
+        event.code = code;
+        is_changed = true;
+      }
+    }
+  }
+  return is_changed;
+}
+
+
+void Action::
+resolve(Keymap const& keymap)
+{
+  for (auto& event: events_)
+  {
+    if (event.keysym != Keymap::no_symbol)
+      event.code = keymap.to_keycode(event.keysym);
+  }
+}
+
+
 std::ostream&
 operator<<(std::ostream& ostr, Action const& action)
 {
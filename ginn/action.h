@@ -69,7 +69,8 @@ public:
   struct Event
   {
     EventType        type;         ///< the type of event
-    Keymap::Keycode  code;         ///< the keycode
+    Keymap::Keycode  code;         ///< the keycode (or button number)
+    Keymap::Keysym   keysym;       ///< the keysym of a key event
   };
 
   /** A collection of action events that make up an actipon. */
@@ -93,11 +94,33 @@ public:
   EventList::const_iterator
   end() const;
 
+  /**
+   * Looks up the keycodes of the key events with changed keysyms again.
+   * @param[in] keymap   The current keymap.
+   * @param[in] changed  The keysyms whose keycodes have changed.
+   * @returns true if any keycode was changed.
+   */
+  bool
+  resolve(Keymap const& keymap, Keymap::KeysymList const& changed);
+
+  /** Looks up the keycodes of all key events. */
+  void
+  resolve(Keymap const& keymap);
+
 private:
   EventList events_;
 };
 
 
+/** Indicates if two actions consist of the same events. */
+bool
+operator==(Action const& lhs, Action const& rhs);
+
+/** Indicates if two actions do not consist of the same events. */
+inline bool
+operator!=(Action const& lhs, Action const& rhs)
+{ return !(lhs == rhs); }
+
 /** Formats an action as a readable string. */
 std::ostream&
 operator<<(std::ostream& ostr, Action const& action);
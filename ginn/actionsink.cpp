@@ -28,6 +28,12 @@ ActionSink::
 {
 }
 
+
+void ActionSink::
+flush()
+{
+}
+
 } // namespace Ginn
 
 
@@ -49,6 +49,15 @@ public:
 
   virtual void
   perform(Action const& action) = 0;
+
+  /**
+   * Sends off any performed actions that may have been queued.
+   *
+   * Sinks may batch the actions performed in response to a single gesture
+   * event and send them all at once when this is called.
+   */
+  virtual void
+  flush();
 };
 
 } // namespace Ginn
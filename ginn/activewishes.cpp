@@ -20,12 +20,22 @@
  */
 #include "ginn/activewishes.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <chrono>
+#include <cstdint>
 #include "ginn/actionsink.h"
 #include "ginn/applicationsource.h"
 #include "ginn/configuration.h"
+#include "ginn/gestureaccumulator.h"
 #include "ginn/gesturesource.h"
+#include "ginn/slotmap.h"
 #include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 
@@ -34,15 +44,107 @@ namespace Ginn
 
 /**
  * A tuple relating a Wish, an Application Window, and a Gesture Subscription.
+ *
+ * The subscriptions of each window are chained through their handles into an
+ * intrusive list, in the order the wishes were granted.
  */
 struct WishWindowSub
 {
   Wish::Ptr                wish_;
   Window const*            window_;
   GestureSubscription::Ptr subscription_;
+  SlotHandle               next_;
 };
 
-using WishSubs = std::vector<WishWindowSub>;
+using WishSubs = SlotMap<WishWindowSub>;
+
+/** The ends of a window's list of subscriptions. */
+struct WindowSubList
+{
+  SlotHandle first_;
+  SlotHandle last_;
+};
+
+/** The subscription lists of all windows with granted wishes. */
+using WindowSubs = std::unordered_map<Window::Id, WindowSubList>;
+
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * The firing state of a wish for one gesture in progress.
+ *
+ * The state belongs to the gesture identified by the serial and is reset when
+ * a new gesture takes over its accumulator slot.
+ *
+ * The baseline is the accumulated value of the trigger property at the time
+ * the wish was last fulfilled, so an accumulated trigger starts counting again
+ * from zero after firing.  The fire count, last fire time, and armed flag
+ * enforce the wish's firing policy.
+ */
+struct FiringState
+{
+  std::uint32_t      gesture_serial_;
+  float              baseline_;
+  unsigned int       fire_count_;
+  Clock::time_point  last_fire_;
+  bool               armed_;
+};
+
+/**
+ * A wish granted on a window, along with its firing state for each gesture
+ * accumulator slot, so gestures in progress at the same time do not reset
+ * each other's state.
+ */
+struct DispatchEntry
+{
+  Wish::Ptr                                                   wish_;
+  std::array<FiringState, GestureAccumulator::max_gestures>   firing_;
+};
+
+/** The granted wishes for one phase of a gesture. */
+using PhaseWishes = std::vector<DispatchEntry>;
+
+/**
+ * The wishes granted on a window for a single gesture class and touch count,
+ * partitioned by the gesture phase during which they may be fulfilled.
+ */
+struct DispatchBucket
+{
+  std::string                                     gesture_;
+  int                                             touches_;
+  std::array<PhaseWishes, gesture_phase_count>    wishes_;
+};
+
+/** All the dispatch buckets for a single window. */
+using DispatchTable = std::vector<DispatchBucket>;
+
+/** The dispatch tables of all windows with granted wishes. */
+using DispatchIndex = std::unordered_map<Window::Id, DispatchTable>;
+
+/**
+ * The dispatch table of an application under the root subscription policy,
+ * shared by all of the application's windows.
+ */
+struct AppDispatch
+{
+  WishIndex::WishList wishes_;        ///< the wishes the table was built from
+  DispatchTable       table_;
+  std::size_t         window_count_;  ///< the windows with wishes granted
+};
+
+/** The application dispatch tables under the root subscription policy. */
+using AppDispatchIndex = std::unordered_map<Application const*, std::unique_ptr<AppDispatch>>;
+
+/** A window with wishes granted under the root subscription policy. */
+struct RootWindow
+{
+  Application const*  application_;
+  WishIndex::WishList granted_;
+};
+
+/** Identifies a root window subscription by gesture class and touch count. */
+using RootSubKey = std::pair<std::string, int>;
 
 
 struct ActiveWishes::Impl
@@ -58,9 +160,45 @@ struct ActiveWishes::Impl
   void
   grant_wishes(Wish::Table const& wishes, Window const* window);
 
+  void
+  add_subscription(Window const* window, Wish::Ptr const& wish);
+
+  void
+  add_to_dispatch_index(Window::Id window_id, Wish::Ptr const& wish);
+
+  static void
+  add_to_dispatch_table(DispatchTable& table, Wish::Ptr const& wish);
+
+  void
+  grant_root_wishes(Window const* window, WishIndex::WishList const& wanted);
+
+  void
+  revoke_root_wishes(Window const* window);
+
+  void
+  update_root_window(Window const* window);
+
+  PhaseWishes::iterator
+  find_in_dispatch_index(Window::Id window_id, Wish::Ptr const& wish, PhaseWishes*& wishes);
+
+  std::set<std::string>
+  reconcile_subscriptions(Window const* window, WishIndex::WishList const& wanted);
+
+  bool
+  wants_subscriptions(Window const* window) const;
+
   Configuration      config_;
+  SubscriptionPolicy subscription_policy_;
   GestureSource*     gesture_source_;
   WishSubs           wish_subs_;
+  WindowSubs         window_subs_;
+  DispatchIndex      dispatch_index_;
+  AppDispatchIndex   app_dispatch_index_;
+  std::unordered_map<Window::Id, RootWindow>        root_windows_;
+  std::map<RootSubKey, GestureSubscription::Ptr>    root_subs_;
+  DispatchTable*     focused_table_;
+  Window::Id         focused_window_;
+  GestureAccumulator accumulator_;
   Callback           wish_granted_callback_;
   Callback           wish_revoked_callback_;
 };
@@ -69,10 +207,330 @@ struct ActiveWishes::Impl
 ActiveWishes::Impl::
 Impl(Configuration const& config, GestureSource* gesture_source)
 : config_(config)
+, subscription_policy_(config.subscription_policy())
 , gesture_source_(gesture_source)
+, focused_table_(nullptr)
+, focused_window_(0)
 { }
 
 
+/**
+ * Indicates if a window's granted wishes should hold gesture subscriptions.
+ */
+bool ActiveWishes::Impl::
+wants_subscriptions(Window const* window) const
+{
+  if (subscription_policy_ == SubscriptionPolicy::lazy)
+    return window->is_active_ || window->is_visible_;
+  return true;
+}
+
+
+/**
+ * Subscribes to the gesture of a granted wish and appends the subscription to
+ * the list for its window.
+ * @param[in] window  The window the wish is granted on.
+ * @param[in] wish    The wish being granted.
+ *
+ * If the window does not want subscriptions right now the wish is still
+ * granted, and the gesture is subscribed to when the window does.
+ */
+void ActiveWishes::Impl::
+add_subscription(Window const* window, Wish::Ptr const& wish)
+{
+  GestureSubscription::Ptr subscription;
+  if (wants_subscriptions(window))
+    subscription = gesture_source_->subscribe(window->id_, wish);
+  SlotHandle handle = wish_subs_.insert(WishWindowSub{wish,
+                                                      window,
+                                                      std::move(subscription),
+                                                      null_slot_handle});
+  auto list = window_subs_.find(window->id_);
+  if (list == std::end(window_subs_))
+  {
+    window_subs_.emplace(window->id_, WindowSubList{handle, handle});
+  }
+  else
+  {
+    wish_subs_.get(list->second.last_)->next_ = handle;
+    list->second.last_ = handle;
+  }
+}
+
+
+/**
+ * Adds a granted wish to the dispatch table for its window.
+ * @param[in] window_id  Identifies the window the wish is granted on.
+ * @param[in] wish       The wish being granted.
+ */
+void ActiveWishes::Impl::
+add_to_dispatch_index(Window::Id window_id, Wish::Ptr const& wish)
+{
+  add_to_dispatch_table(dispatch_index_[window_id], wish);
+}
+
+
+/**
+ * Adds a wish to a dispatch table.
+ * @param[in] table  The dispatch table.
+ * @param[in] wish   The wish being added.
+ */
+void ActiveWishes::Impl::
+add_to_dispatch_table(DispatchTable& table, Wish::Ptr const& wish)
+{
+  auto bucket = std::find_if(std::begin(table), std::end(table),
+                             [&wish](DispatchBucket const& b) -> bool
+                             { return b.touches_ == wish->touches()
+                                   && b.gesture_ == wish->gesture(); });
+  if (bucket == std::end(table))
+  {
+    table.push_back(DispatchBucket{wish->gesture(), wish->touches(), {}});
+    bucket = std::end(table) - 1;
+  }
+  bucket->wishes_[static_cast<std::size_t>(wish->when())].push_back(DispatchEntry{wish, {}});
+}
+
+
+/**
+ * Finds a granted wish in the dispatch table for its window.
+ * @param[in]  window_id  Identifies the window the wish is granted on.
+ * @param[in]  wish       The granted wish.
+ * @param[out] wishes     The phase wishes holding the entry, if found.
+ *
+ * @returns the dispatch entry for the wish, or nothing.
+ */
+PhaseWishes::iterator ActiveWishes::Impl::
+find_in_dispatch_index(Window::Id window_id, Wish::Ptr const& wish, PhaseWishes*& wishes)
+{
+  wishes = nullptr;
+  auto table = dispatch_index_.find(window_id);
+  if (table == std::end(dispatch_index_))
+    return PhaseWishes::iterator();
+
+  for (auto& bucket: table->second)
+  {
+    if (bucket.touches_ != wish->touches() || bucket.gesture_ != wish->gesture())
+      continue;
+    PhaseWishes& phase_wishes = bucket.wishes_[static_cast<std::size_t>(wish->when())];
+    auto entry = std::find_if(std::begin(phase_wishes), std::end(phase_wishes),
+                              [&wish](DispatchEntry const& e) -> bool
+                              { return e.wish_ == wish; });
+    if (entry != std::end(phase_wishes))
+    {
+      wishes = &phase_wishes;
+      return entry;
+    }
+  }
+  return PhaseWishes::iterator();
+}
+
+
+/**
+ * Brings the wishes already granted on a window in line with the wanted ones.
+ * @param[in] window  The window.
+ * @param[in] wanted  The wishes the window should have.
+ *
+ * A granted wish that is still wanted and unchanged keeps its subscription and
+ * firing state, and just takes over the new copy of the wish.  Any other
+ * granted wish is revoked.
+ *
+ * @returns the names of the wanted wishes that are already granted.
+ */
+std::set<std::string> ActiveWishes::Impl::
+reconcile_subscriptions(Window const* window, WishIndex::WishList const& wanted)
+{
+  std::set<std::string> kept;
+  auto list = window_subs_.find(window->id_);
+  if (list == std::end(window_subs_))
+    return kept;
+
+  SlotHandle prev = null_slot_handle;
+  SlotHandle handle = list->second.first_;
+  while (WishWindowSub* sub = wish_subs_.get(handle))
+  {
+    SlotHandle next = sub->next_;
+    PhaseWishes* phase_wishes = nullptr;
+    auto entry = find_in_dispatch_index(window->id_, sub->wish_, phase_wishes);
+
+    Wish::Ptr wish = WishIndex::find(wanted, sub->wish_->name());
+    if (wish && *wish == *sub->wish_)
+    {
+      if (phase_wishes)
+        entry->wish_ = wish;
+      sub->wish_ = wish;
+      kept.insert(wish->name());
+      prev = handle;
+    }
+    else
+    {
+      if (wish_revoked_callback_)
+        wish_revoked_callback_(*sub->wish_, *window);
+      if (config_.is_verbose_mode())
+        std::cout << __PRETTY_FUNCTION__ << " wish " << *sub->wish_
+                  << " revoked for window " << *window << "\n";
+      if (phase_wishes)
+        phase_wishes->erase(entry);
+
+      if (prev.is_null())
+        list->second.first_ = next;
+      else
+        wish_subs_.get(prev)->next_ = next;
+      if (list->second.last_ == handle)
+        list->second.last_ = prev;
+      wish_subs_.erase(handle);
+    }
+    handle = next;
+  }
+
+  if (list->second.first_.is_null())
+  {
+    window_subs_.erase(list);
+    dispatch_index_.erase(window->id_);
+  }
+  return kept;
+}
+
+
+/**
+ * Grants the wishes for a window under the root subscription policy.
+ * @param[in] window  The window.
+ * @param[in] wanted  The wishes the window should have.
+ *
+ * Each gesture class and touch count is subscribed to once, on the root
+ * window, the first time any window wants it, and stays subscribed; windows
+ * coming and going cause no subscription churn.  The windows of an
+ * application share one dispatch table, which is rebuilt only if the
+ * application's wishes have changed.
+ */
+void ActiveWishes::Impl::
+grant_root_wishes(Window const* window, WishIndex::WishList const& wanted)
+{
+  for (auto const& wish: wanted)
+  {
+    RootSubKey key{wish->gesture(), wish->touches()};
+    if (root_subs_.count(key))
+      continue;
+    root_subs_.emplace(key, gesture_source_->subscribe(GestureSource::root_window, wish));
+    if (config_.is_verbose_mode())
+      std::cout << __PRETTY_FUNCTION__ << " subscribed to " << wish->gesture()
+                << wish->touches() << " on the root window\n";
+  }
+
+  Application const* app = window->application_;
+  std::unique_ptr<AppDispatch>& dispatch = app_dispatch_index_[app];
+  if (!dispatch)
+    dispatch.reset(new AppDispatch{WishIndex::WishList(), DispatchTable(), 0});
+  if (dispatch->wishes_ != wanted)
+  {
+    dispatch->wishes_ = wanted;
+    dispatch->table_.clear();
+    for (auto const& wish: wanted)
+      add_to_dispatch_table(dispatch->table_, wish);
+  }
+
+  auto inserted = root_windows_.emplace(window->id_, RootWindow{app, WishIndex::WishList()});
+  RootWindow& root_window = inserted.first->second;
+  if (inserted.second)
+    ++dispatch->window_count_;
+
+  for (auto const& wish: root_window.granted_)
+  {
+    Wish::Ptr kept = WishIndex::find(wanted, wish->name());
+    if ((!kept || *kept != *wish) && wish_revoked_callback_)
+      wish_revoked_callback_(*wish, *window);
+  }
+  for (auto const& wish: wanted)
+  {
+    Wish::Ptr granted = WishIndex::find(root_window.granted_, wish->name());
+    if (!granted || *granted != *wish)
+    {
+      if (config_.is_verbose_mode())
+        std::cout << __PRETTY_FUNCTION__ << " granting wish '" << wish->name() << "' for window: " << *window << "\n";
+      if (wish_granted_callback_)
+        wish_granted_callback_(*wish, *window);
+    }
+  }
+  root_window.granted_ = wanted;
+
+  if (window->is_active_)
+  {
+    focused_table_ = &dispatch->table_;
+    focused_window_ = window->id_;
+  }
+}
+
+
+/**
+ * Revokes the wishes for a window under the root subscription policy.
+ *
+ * The application's dispatch table goes when its last window does, but the
+ * root window subscriptions stay.
+ */
+void ActiveWishes::Impl::
+revoke_root_wishes(Window const* window)
+{
+  auto root_window = root_windows_.find(window->id_);
+  if (root_window == std::end(root_windows_))
+    return;
+
+  for (auto const& wish: root_window->second.granted_)
+  {
+    if (wish_revoked_callback_)
+      wish_revoked_callback_(*wish, *window);
+    if (config_.is_verbose_mode())
+      std::cout << __PRETTY_FUNCTION__ << " wish " << *wish
+                << " revoked for window " << *window << "\n";
+  }
+
+  if (focused_window_ == window->id_)
+    focused_table_ = nullptr;
+  auto dispatch = app_dispatch_index_.find(root_window->second.application_);
+  if (dispatch != std::end(app_dispatch_index_) && --dispatch->second->window_count_ == 0)
+  {
+    if (focused_table_ == &dispatch->second->table_)
+      focused_table_ = nullptr;
+    app_dispatch_index_.erase(dispatch);
+  }
+  root_windows_.erase(root_window);
+}
+
+
+/**
+ * Switches the dispatch table in use when the focus moves to or away from a
+ * window under the root subscription policy.
+ *
+ * The focus moving to a window without granted wishes leaves no dispatch
+ * table in use at all.
+ */
+void ActiveWishes::Impl::
+update_root_window(Window const* window)
+{
+  auto root_window = root_windows_.find(window->id_);
+  if (root_window == std::end(root_windows_))
+  {
+    if (window->is_active_)
+    {
+      focused_table_ = nullptr;
+      focused_window_ = window->id_;
+    }
+    return;
+  }
+
+  if (window->is_active_)
+  {
+    focused_table_ = &app_dispatch_index_[root_window->second.application_]->table_;
+    focused_window_ = window->id_;
+    if (config_.is_verbose_mode())
+      std::cout << __PRETTY_FUNCTION__ << " dispatching to "
+                << window->application_->name() << "\n";
+  }
+  else if (focused_window_ == window->id_)
+  {
+    focused_table_ = nullptr;
+  }
+}
+
+
 ActiveWishes::
 ActiveWishes(Configuration const& config, GestureSource* gesture_source)
 : impl_(new Impl(config, gesture_source))
@@ -99,33 +557,35 @@ set_wish_revoked_callback(Callback const& wish_revoked_callback)
 
 
 void ActiveWishes::
-grant_wishes_for_window(Wish::Table const& wishes, Window const* window)
+grant_wishes_for_window(WishIndex const& wishes, Window const* window)
 {
   assert(window != nullptr);
 
   Application const* app = window->application_;
   assert(app != nullptr);
 
-  auto wish_table_it = wishes.find(app->application_id());
-  if (wish_table_it == std::end(wishes))
+  WishIndex::WishList const& wanted = wishes.wishes_for(*app);
+  if (impl_->subscription_policy_ == SubscriptionPolicy::root)
   {
-    wish_table_it = wishes.find(app->name());
+    impl_->grant_root_wishes(window, wanted);
+    return;
   }
-  if (wish_table_it != std::end(wishes))
+
+  std::set<std::string> kept = impl_->reconcile_subscriptions(window, wanted);
+  for (auto const& wish: wanted)
   {
-    for (auto const& wish: wish_table_it->second)
-    {
-      if (impl_->config_.is_verbose_mode())
-        std::cout << __PRETTY_FUNCTION__ << " granting wish '" << wish.second->name() << "'for window: " << *window << "\n";
+    if (kept.count(wish->name()))
+      continue;
 
-      /** @todo: actually grant wish */
-      impl_->wish_subs_.push_back(WishWindowSub{wish.second,
-                                                window,
-                                                impl_->gesture_source_->subscribe(window->id_, wish.second)});
+    if (impl_->config_.is_verbose_mode())
+      std::cout << __PRETTY_FUNCTION__ << " granting wish '" << wish->name() << "'for window: " << *window << "\n";
 
-      if (impl_->wish_granted_callback_)
-        impl_->wish_granted_callback_(*wish.second, *window);
-    }
+    /** @todo: actually grant wish */
+    impl_->add_subscription(window, wish);
+    impl_->add_to_dispatch_index(window->id_, wish);
+
+    if (impl_->wish_granted_callback_)
+      impl_->wish_granted_callback_(*wish, *window);
   }
 }
 
@@ -135,39 +595,183 @@ revoke_wishes_for_window(Window const* window)
 {
   assert(window != nullptr);
 
-  auto it = std::begin(impl_->wish_subs_);
-  while (it != std::end(impl_->wish_subs_))
+  if (impl_->subscription_policy_ == SubscriptionPolicy::root)
   {
-    if (it->window_ == window)
+    impl_->revoke_root_wishes(window);
+    return;
+  }
+
+  auto list = impl_->window_subs_.find(window->id_);
+  if (list != std::end(impl_->window_subs_))
+  {
+    SlotHandle handle = list->second.first_;
+    while (WishWindowSub* sub = impl_->wish_subs_.get(handle))
     {
       if (impl_->wish_revoked_callback_)
       {
-        impl_->wish_revoked_callback_(*it->wish_, *window);
+        impl_->wish_revoked_callback_(*sub->wish_, *window);
       }
       if (impl_->config_.is_verbose_mode())
-        std::cout << __PRETTY_FUNCTION__ << " wish " << *it->wish_
+        std::cout << __PRETTY_FUNCTION__ << " wish " << *sub->wish_
                   << " revoked for window " << *window << "\n";;
-      it = impl_->wish_subs_.erase(it);
-    }
-    else
-    {
-      ++it;
+      SlotHandle next = sub->next_;
+      impl_->wish_subs_.erase(handle);
+      handle = next;
     }
+    impl_->window_subs_.erase(list);
   }
+  impl_->dispatch_index_.erase(window->id_);
   if (impl_->config_.is_verbose_mode())
     std::cout << __PRETTY_FUNCTION__ << " window removed: " << *window << "\n";;
 }
 
 
+/**
+ * Gesture subscriptions are only ever dropped or made again here under the
+ * lazy subscription policy; the granted wishes and their dispatch state stay
+ * as they are.  Under the root subscription policy only the dispatch table in
+ * use changes.
+ */
+void ActiveWishes::
+update_window(Window const* window)
+{
+  assert(window != nullptr);
+
+  if (impl_->subscription_policy_ == SubscriptionPolicy::root)
+  {
+    impl_->update_root_window(window);
+    return;
+  }
+
+  auto list = impl_->window_subs_.find(window->id_);
+  if (list == std::end(impl_->window_subs_))
+    return;
+
+  bool wants_subscriptions = impl_->wants_subscriptions(window);
+  int changed_count = 0;
+  SlotHandle handle = list->second.first_;
+  while (WishWindowSub* sub = impl_->wish_subs_.get(handle))
+  {
+    if (wants_subscriptions && !sub->subscription_)
+    {
+      sub->subscription_ = impl_->gesture_source_->subscribe(window->id_, sub->wish_);
+      ++changed_count;
+    }
+    else if (!wants_subscriptions && sub->subscription_)
+    {
+      sub->subscription_.reset();
+      ++changed_count;
+    }
+    handle = sub->next_;
+  }
+
+  if (changed_count && impl_->config_.is_verbose_mode())
+    std::cout << __PRETTY_FUNCTION__ << " " << changed_count << " subscriptions "
+              << (wants_subscriptions ? "activated" : "deactivated")
+              << " for window " << *window << "\n";
+}
+
+
+/**
+ * Performs the actions of all granted wishes fulfilled by a gesture event.
+ * @param[in] gesture_event  The gesture event.
+ * @param[in] action_sink    Where to send the actions of fulfilled wishes.
+ *
+ * Only the dispatch tables of the windows actually named in the event's frames
+ * are visited (under the root subscription policy, the dispatch table of the
+ * application with the focus), and only the wishes for the event's gesture phase in the buckets
+ * with a matching gesture class and touch count get checked.
+ *
+ * Every frame is added to the accumulated state of its gesture, even if no
+ * wishes end up being checked, and that state is dropped when the gesture
+ * ends.
+ *
+ * A wish in range is fulfilled only if its firing policy allows:  it has not
+ * yet been fulfilled its maximum number of times during the gesture, its
+ * minimum interval has passed since it was last fulfilled, and, if it needs
+ * re-arming, the trigger value has left its range since then.  The monotonic
+ * clock is read once per event.
+ *
+ * The action sink is flushed once after all the event's actions have been
+ * performed.
+ */
 void ActiveWishes::
 process_gesture_event(GestureEvent const& gesture_event,
                       ActionSink*         action_sink)
 {
-  for (auto const& active_wish: impl_->wish_subs_)
+  std::size_t phase = static_cast<std::size_t>(gesture_event.phase());
+  Clock::time_point now = Clock::now();
+  bool performed = false;
+  for (std::size_t frame = 0; frame < gesture_event.frame_count(); ++frame)
   {
-    if (gesture_event.matches(active_wish.window_, active_wish.wish_))
-      action_sink->perform(active_wish.wish_->action());
+    GestureEvent::GestureId gesture_id = gesture_event.gesture_id(frame);
+    PropertySnapshot const& properties = gesture_event.properties(frame);
+    GestureAccumulator::Gesture const& gesture =
+        impl_->accumulator_.accumulate(gesture_id, properties);
+
+    DispatchTable* table = impl_->focused_table_;
+    if (impl_->subscription_policy_ != SubscriptionPolicy::root)
+    {
+      auto it = impl_->dispatch_index_.find(gesture_event.window_id(frame));
+      table = (it != std::end(impl_->dispatch_index_)) ? &it->second : nullptr;
+    }
+    if (table)
+    {
+      for (auto& bucket: *table)
+      {
+        PhaseWishes& wishes = bucket.wishes_[phase];
+        if (wishes.empty()
+         || !gesture_event.is_gesture(frame, bucket.gesture_, bucket.touches_))
+          continue;
+
+        for (auto& entry: wishes)
+        {
+          Wish const& wish = *entry.wish_;
+          Property::Id property_id = wish.property_id();
+          if (!properties.has(property_id))
+            continue;
+
+          FiringState& firing = entry.firing_[gesture.slot];
+          if (firing.gesture_serial_ != gesture.serial)
+          {
+            firing.gesture_serial_ = gesture.serial;
+            firing.baseline_ = 0.0f;
+            firing.fire_count_ = 0;
+            firing.armed_ = true;
+          }
+
+          float value = properties.value(property_id);
+          if (wish.trigger_mode() == Wish::TriggerMode::accumulated)
+            value = gesture.sums[property_id] - firing.baseline_;
+
+          if (!wish.is_triggered_by(value))
+          {
+            if (!firing.armed_ && wish.is_rearmed_by(value))
+              firing.armed_ = true;
+            continue;
+          }
+
+          if (!firing.armed_
+           || (wish.max_fires() > 0 && firing.fire_count_ >= wish.max_fires())
+           || (firing.fire_count_ > 0 && now - firing.last_fire_ < wish.min_interval()))
+            continue;
+
+          action_sink->perform(wish.action());
+          performed = true;
+          firing.baseline_ = gesture.sums[property_id];
+          firing.last_fire_ = now;
+          ++firing.fire_count_;
+          firing.armed_ = !wish.needs_rearm();
+        }
+      }
+    }
+
+    if (gesture_event.phase() == GesturePhase::end)
+      impl_->accumulator_.release(gesture_id);
   }
+
+  if (performed)
+    action_sink->flush();
 }
 
 } // namespace Ginn
@@ -22,7 +22,9 @@
 #define GINN_ACTIVEWISHES_H_
 
 #include <functional>
+#include "ginn/policies.h"
 #include "ginn/wish.h"
+#include "ginn/wishindex.h"
 #include <memory>
 
 
@@ -44,6 +46,16 @@ namespace Ginn
  *
  * The active wishes collection is a dynamic entity, because application windows
  * may come and go as they please.
+ *
+ * Under the lazy subscription policy the gesture subscriptions of a window's
+ * granted wishes are only held while the window is on screen (not minimized
+ * and on the current workspace) or has the focus, so the load on the gesture recognizer follows what is on screen rather than
+ * everything that is open.
+ *
+ * Under the root subscription policy each gesture class and touch count is
+ * subscribed to just once, on the root window, and each application gets a
+ * precompiled dispatch table.  A focus change swaps the table in use, and
+ * windows coming and going cause no subscription churn at all.
  */
 class ActiveWishes
 {
@@ -63,12 +75,29 @@ public:
   void
   set_wish_revoked_callback(Callback const& wish_revoked_callback);
 
+  /**
+   * Grants the wishes for a window's application.
+   *
+   * The application's wishes, including the global wishes, are found through
+   * the wish index.
+   *
+   * If the window already has wishes granted, only the difference is applied:
+   * granted wishes that are unchanged keep their subscriptions, those that
+   * are gone or changed are revoked, and new ones are granted.
+   */
   void
-  grant_wishes_for_window(Wish::Table const& wishes, Window const* window);
+  grant_wishes_for_window(WishIndex const& wishes, Window const* window);
 
   void
   revoke_wishes_for_window(Window const* window);
 
+  /**
+   * Brings a window's gesture subscriptions in line with its focus and
+   * visibility after they have changed.
+   */
+  void
+  update_window(Window const* window);
+
   void
   process_gesture_event(GestureEvent const& gesture_event,
                         ActionSink*         action_sink);
@@ -20,7 +20,6 @@
  */
 #include "ginn/application.h"
 
-#include <algorithm>
 #include "ginn/applicationbuilder.h"
 #include <iostream>
 #include <utility>
@@ -59,15 +58,30 @@ generic_name() const
 }
 
 
+void Application::
+set_generic_name(std::string const& generic_name)
+{
+  generic_name_ = generic_name;
+}
+
+
 Window const* Application::
 window(Window::Id window_id) const
 {
-  auto it = std::find_if(std::begin(windows_), std::end(windows_),
-                         [&window_id](std::unique_ptr<Window> const& w) -> bool
-                         { return window_id == w->id_; });
+  auto it = windows_.find(window_id);
   if (it == std::end(windows_))
     return nullptr;
-  return it->get();
+  return it->second.get();
+}
+
+
+Window* Application::
+window(Window::Id window_id)
+{
+  auto it = windows_.find(window_id);
+  if (it == std::end(windows_))
+    return nullptr;
+  return it->second.get();
 }
 
 
@@ -76,26 +90,26 @@ for_all_windows(WindowVisitor const& window_visitor)
 {
   for (auto const& window: windows_)
   {
-    window_visitor(window.get());
+    window_visitor(window.second.get());
   }
 }
 
 
-void Application::
+Window const* Application::
 add_window(std::unique_ptr<Window> window)
 {
-  windows_.push_back(std::move(window));
+  Window::Id window_id = window->id_;
+  auto inserted = windows_.emplace(window_id, std::move(window));
+  if (!inserted.second)
+    return nullptr;
+  return inserted.first->second.get();
 }
 
 
 void Application::
 remove_window(Window::Id window_id)
 {
-  auto it = std::find_if(std::begin(windows_), std::end(windows_),
-                         [&window_id](std::unique_ptr<Window> const& w) -> bool
-                         { return window_id == w->id_; });
-  if (it == std::end(windows_))
-    windows_.erase(it);
+  windows_.erase(window_id);
 }
 
 
@@ -108,7 +122,7 @@ dump(std::ostream& ostr) const
        << "\n";
   for (auto const& window: windows_)
   {
-    std::cout << "    " << *window << "\n";;
+    std::cout << "    " << *window.second << "\n";;
   }
   return ostr;
 }
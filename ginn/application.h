@@ -26,7 +26,7 @@
 #include <map>
 #include <memory>
 #include <string>
-#include <vector>
+#include <unordered_map>
 #include "ginn/window.h"
 
 
@@ -66,18 +66,35 @@ public:
   std::string const&
   generic_name() const;
 
-  /** Gets a particular cuurent window by window_id. */
+  /** Updates the GenericName once the desktop file has been read. */
+  void
+  set_generic_name(std::string const& generic_name);
+
+  /** Gets a particular current window by window_id, in constant time. */
   Window const*
   window(Window::Id window_id) const;
 
+  /** Gets a particular current window by window_id so its state can change. */
+  Window*
+  window(Window::Id window_id);
+
   void
   for_all_windows(WindowVisitor const& window_visitor);
 
-  /** Adds a new tracked window. */
-  void
+  /**
+   * Adds a new tracked window.
+   * @returns the tracked window, or nullptr if a window with the same id is
+   * already tracked.
+   */
+  Window const*
   add_window(std::unique_ptr<Window> window);
 
-  /** Removes a particular cuurent window by window_id. */
+  /** Gets the number of current windows. */
+  std::size_t
+  window_count() const
+  { return windows_.size(); }
+
+  /** Removes a particular current window by window_id. */
   void
   remove_window(Window::Id window_id);
 
@@ -86,7 +103,7 @@ public:
   dump(std::ostream& ostr) const;
 
 private:
-  using Windows = std::vector<std::unique_ptr<Window>>;
+  using Windows = std::unordered_map<Window::Id, std::unique_ptr<Window>>;
 
   Id           application_id_;  ///< name of the desktop file
   std::string  name_;            ///< Name key in the desktop file
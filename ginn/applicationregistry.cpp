@@ -0,0 +1,147 @@
+/**
+ * @file ginn/applicationregistry.cpp
+ * @brief Definitions of the Ginn Application Registry module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/applicationregistry.h"
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+
+namespace Ginn
+{
+
+ApplicationRegistry::
+ApplicationRegistry()
+{ }
+
+
+ApplicationRegistry::
+~ApplicationRegistry()
+{ }
+
+
+Application* ApplicationRegistry::
+application(Application::Id const& application_id) const
+{
+  auto it = applications_.find(application_id);
+  if (it == std::end(applications_))
+    return nullptr;
+  return it->second.get();
+}
+
+
+Application* ApplicationRegistry::
+add_application(std::unique_ptr<Application> app)
+{
+  Application::Id application_id = app->application_id();
+  auto inserted = applications_.emplace(application_id, std::move(app));
+  return inserted.first->second.get();
+}
+
+
+bool ApplicationRegistry::
+remove_application(Application::Id const& application_id,
+                   WindowVisitor const&   window_visitor)
+{
+  auto it = applications_.find(application_id);
+  if (it == std::end(applications_))
+    return false;
+
+  std::vector<Window::Id> window_ids;
+  window_ids.reserve(it->second->window_count());
+  it->second->for_all_windows([&window_ids](Window const* window)
+                              { window_ids.push_back(window->id_); });
+  for (auto window_id: window_ids)
+    remove_window(window_id, window_visitor);
+  applications_.erase(it);
+  return true;
+}
+
+
+Window const* ApplicationRegistry::
+window(Window::Id window_id) const
+{
+  auto it = windows_.find(window_id);
+  if (it == std::end(windows_))
+    return nullptr;
+  return it->second->window(window_id);
+}
+
+
+Window* ApplicationRegistry::
+window(Window::Id window_id)
+{
+  auto it = windows_.find(window_id);
+  if (it == std::end(windows_))
+    return nullptr;
+  return it->second->window(window_id);
+}
+
+
+Window const* ApplicationRegistry::
+add_window(Application* app, std::unique_ptr<Window> window)
+{
+  assert(app != nullptr && application(app->application_id()) == app);
+  assert(window->application_ == app);
+
+  Window::Id window_id = window->id_;
+  if (windows_.count(window_id))
+    return nullptr;
+
+  Window const* w = app->add_window(std::move(window));
+  if (w)
+    windows_.emplace(window_id, app);
+  return w;
+}
+
+
+bool ApplicationRegistry::
+remove_window(Window::Id window_id, WindowVisitor const& window_visitor)
+{
+  auto it = windows_.find(window_id);
+  if (it == std::end(windows_))
+    return false;
+
+  Application* app = it->second;
+  if (window_visitor)
+    window_visitor(app->window(window_id));
+  windows_.erase(it);
+  app->remove_window(window_id);
+  return true;
+}
+
+
+void ApplicationRegistry::
+for_all_windows(WindowVisitor const& window_visitor) const
+{
+  for (auto const& app: applications_)
+    app.second->for_all_windows(window_visitor);
+}
+
+
+void ApplicationRegistry::
+for_all_applications(ApplicationVisitor const& application_visitor) const
+{
+  for (auto const& app: applications_)
+    application_visitor(app.second.get());
+}
+
+} // namespace Ginn
@@ -0,0 +1,134 @@
+/**
+ * @file ginn/applicationregistry.h
+ * @brief Declarations of the Ginn Application Registry module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_APPLICATIONREGISTRY_H_
+#define GINN_APPLICATIONREGISTRY_H_
+
+#include "ginn/application.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+
+namespace Ginn
+{
+
+/**
+ * The running applications and their windows, indexed for constant-time
+ * lookup.
+ *
+ * Applications are indexed by their id (the desktop file) and windows by
+ * their id (the XID).  The registry owns the applications, which own their
+ * windows, so the Application and Window pointers handed out stay valid until
+ * the application or window is removed.
+ */
+class ApplicationRegistry
+{
+public:
+  /** A visitor function for window processing. */
+  using WindowVisitor = Application::WindowVisitor;
+  /** A visitor function for application processing. */
+  using ApplicationVisitor = std::function<void(Application*)>;
+
+public:
+  ApplicationRegistry();
+
+  ~ApplicationRegistry();
+
+  /** Gets an application by id, or nullptr if it is not registered. */
+  Application*
+  application(Application::Id const& application_id) const;
+
+  /**
+   * Registers an application.
+   * @returns the registered application, which is the one already registered
+   * if there is one with the same id.
+   */
+  Application*
+  add_application(std::unique_ptr<Application> app);
+
+  /**
+   * Unregisters an application and all of its windows.
+   * @param[in] application_id  Identifies the application.
+   * @param[in] window_visitor  Called for each window before it is removed.
+   * @returns true if the application was registered.
+   */
+  bool
+  remove_application(Application::Id const&  application_id,
+                     WindowVisitor const&    window_visitor = WindowVisitor());
+
+  /** Gets a window by id, or nullptr if it is not registered. */
+  Window const*
+  window(Window::Id window_id) const;
+
+  /** Gets a window by id so its state can change, or nullptr. */
+  Window*
+  window(Window::Id window_id);
+
+  /**
+   * Registers a new window with its application.
+   * @param[in] app     The window's (registered) application.
+   * @param[in] window  The window.
+   * @returns the registered window, or nullptr if a window with the same id
+   * is already registered.
+   */
+  Window const*
+  add_window(Application* app, std::unique_ptr<Window> window);
+
+  /**
+   * Unregisters a window.
+   * @param[in] window_id       Identifies the window.
+   * @param[in] window_visitor  Called with the window before it is removed.
+   * @returns true if the window was registered.
+   */
+  bool
+  remove_window(Window::Id            window_id,
+                WindowVisitor const&  window_visitor = WindowVisitor());
+
+  /** Visits every registered window. */
+  void
+  for_all_windows(WindowVisitor const& window_visitor) const;
+
+  /** Visits every registered application. */
+  void
+  for_all_applications(ApplicationVisitor const& application_visitor) const;
+
+  /** Gets the number of registered applications. */
+  std::size_t
+  application_count() const
+  { return applications_.size(); }
+
+  /** Gets the number of registered windows. */
+  std::size_t
+  window_count() const
+  { return windows_.size(); }
+
+private:
+  using Applications = std::unordered_map<Application::Id, std::unique_ptr<Application>>;
+  using Windows = std::unordered_map<Window::Id, Application*>;
+
+  Applications applications_;
+  Windows      windows_;
+};
+
+} // namespace Ginn
+
+#endif // GINN_APPLICATIONREGISTRY_H_
@@ -50,6 +50,9 @@ public:
   /** Signal indicating an application window has been closed. */
   using WindowClosedCallback = std::function<void(Window const*)>;
 
+  /** Signal indicating a window has gained or lost focus or visibility. */
+  using WindowChangedCallback = std::function<void(Window const*)>;
+
 public:
   virtual ~ApplicationSource() = 0;
 
@@ -72,6 +75,13 @@ public:
   virtual void
   set_window_closed_callback(WindowClosedCallback const& callback) = 0;
 
+  /**
+   * Sets a callback to be invoked when a window's is_active_ or is_visible_
+   * state has changed.
+   */
+  virtual void
+  set_window_changed_callback(WindowChangedCallback const& callback) = 0;
+
   /**
    * Reports all currently known windows.
    *
@@ -22,13 +22,18 @@
 
 #include <algorithm>
 #include <cassert>
+#include <deque>
 #include "ginn/application.h"
 #include "ginn/applicationbuilder.h"
+#include "ginn/applicationregistry.h"
 #include "ginn/configuration.h"
-#include <gio/gdesktopappinfo.h>
+#include "ginn/desktopentrycache.h"
+#include "ginn/x11windowstate.h"
 #include <glib.h>
 #include <iostream>
 #include <libbamf/bamf-matcher.h>
+#include <mutex>
+#include <string>
 
 
 using bamf_matcher_t = std::unique_ptr<BamfMatcher, void(*)(gpointer)>;
@@ -37,23 +42,30 @@ using bamf_matcher_t = std::unique_ptr<BamfMatcher, void(*)(gpointer)>;
 namespace Ginn
 {
 
+/**
+ * Builds an Application from a BAMF application.
+ *
+ * The desktop file is asked of BAMF just once, and the desktop file's metadata
+ * comes out of the desktop entry cache rather than being read from disk.  If
+ * the cache does not have it yet, it is filled in once it does.
+ */
 struct BamfApplicationBuilder
 : public ApplicationBuilder
 {
-  BamfApplicationBuilder(BamfMatcher* matcher, BamfApplication* app)
-  : matcher_(matcher)
-  , app_(app)
-  { }
+  BamfApplicationBuilder(BamfApplication* app, DesktopEntryCache& desktop_entries)
+  : app_(app)
+  , desktop_entries_(desktop_entries)
+  {
+    const gchar* desktop_file = bamf_application_get_desktop_file(app_);
+    desktop_file_ = desktop_file ? desktop_file : "";
+  }
 
   ~BamfApplicationBuilder()
   { }
 
   Application::Id
   application_id() const
-  {
-    const gchar* desktop_file = bamf_application_get_desktop_file(app_);
-    return desktop_file ? desktop_file : "";
-  }
+  { return desktop_file_; }
 
   std::string
   name() const
@@ -64,38 +76,19 @@ struct BamfApplicationBuilder
 
   std::string
   generic_name() const
-  {
-    std::string name = "";
-    GDesktopAppInfo* app_info = g_desktop_app_info_new_from_filename(application_id().c_str());
-    if (app_info)
-    {
-      if (g_desktop_app_info_has_key(app_info,
-                                     G_KEY_FILE_DESKTOP_KEY_GENERIC_NAME))
-      {
-        gchar* generic_name = g_desktop_app_info_get_string(app_info,
-                                        G_KEY_FILE_DESKTOP_KEY_GENERIC_NAME);
-        name = generic_name ? generic_name : "";
-        g_free(generic_name);
-      }
-      g_clear_object(&app_info);
-    }
-    return name;
-  }
+  { return desktop_entries_.generic_name(desktop_file_); }
 
-  BamfMatcher*     matcher_;
-  BamfApplication* app_;
+  BamfApplication*   app_;
+  DesktopEntryCache& desktop_entries_;
+  std::string        desktop_file_;
 };
 
 
-using AppPtr = std::unique_ptr<Application>;
-
-
 struct BamfApplicationSource::Impl
 {
   Impl(Configuration const& config);
 
-  ~Impl()
-  { }
+  ~Impl();
 
   Application*
   get_application(BamfApplication* bamf_app);
@@ -112,15 +105,48 @@ struct BamfApplicationSource::Impl
   void
   remove_window(BamfWindow* bamf_window);
 
+  void
+  update_window(BamfWindow* bamf_window);
+
+  void
+  update_window(Window* window, bool is_active, bool is_visible);
+
+  void
+  window_state_changed(Window::Id window_id);
+
+  void
+  desktop_entries_changed();
+
+  static gboolean
+  on_desktop_entries_changed(gpointer data);
+
+  void
+  refresh_desktop_entries();
+
   static gboolean
   do_initialization(gpointer data);
 
+  static gboolean
+  enumerate_windows(gpointer data);
+
+  /** The longest an enumeration slice may keep the main loop busy. */
+  static const gint64 enumeration_slice_us = 4000;
+
   Configuration         config_;
   bamf_matcher_t        matcher_;
-  std::vector<AppPtr>   applications_;
+  DesktopEntryCache     desktop_entries_;
+  X11WindowState        window_state_;
+  ApplicationRegistry   registry_;
   InitializedCallback   initialized_callback_;
   WindowOpenedCallback  window_opened_callback_;
   WindowClosedCallback  window_closed_callback_;
+  WindowChangedCallback window_changed_callback_;
+  std::deque<BamfWindow*> pending_windows_;
+  guint                 initialization_source_;
+  guint                 enumeration_source_;
+  std::mutex            refresh_mutex_;
+  guint                 refresh_source_;
+  bool                  is_initialized_;
 };
 
 
@@ -140,6 +166,15 @@ on_view_opened(BamfMatcher*, BamfView* view, gpointer data)
 }
 
 
+void
+on_window_state_changed(BamfView* view, gboolean, gpointer data)
+{
+  BamfApplicationSource::Impl* impl = static_cast<BamfApplicationSource::Impl*>(data);
+  if (BAMF_IS_WINDOW(view))
+    impl->update_window(BAMF_WINDOW(view));
+}
+
+
 void
 on_view_closed(BamfMatcher*, BamfView* view, gpointer data)
 {
@@ -155,10 +190,21 @@ on_view_closed(BamfMatcher*, BamfView* view, gpointer data)
 }
 
 
+/**
+ * The running applications are gathered as soon as the main loop runs, while
+ * the desktop files are scanned in the background.  Applications registered
+ * before their desktop file has been scanned get their metadata filled in
+ * later.
+ */
 BamfApplicationSource::Impl::
 Impl(Configuration const& config)
 : config_(config)
 , matcher_(bamf_matcher_get_default(), g_object_unref)
+, window_state_(config)
+, initialization_source_(0)
+, enumeration_source_(0)
+, refresh_source_(0)
+, is_initialized_(false)
 {
   g_signal_connect(G_OBJECT(matcher_.get()),
                    "view-opened",
@@ -168,7 +214,64 @@ Impl(Configuration const& config)
                    "view_closed",
                    (GCallback)on_view_closed,
                    this);
-  g_idle_add(do_initialization, this);
+  window_state_.set_changed_callback([this](Window::Id window_id)
+                                    { window_state_changed(window_id); });
+  desktop_entries_.start_scan(DesktopEntryCache::application_directories(),
+                              [this]() { desktop_entries_changed(); });
+  initialization_source_ = g_idle_add(do_initialization, this);
+}
+
+
+/**
+ * Hands a change in the desktop entry cache over to the main loop.
+ *
+ * This is called on the cache's worker thread.  The idle source is recorded
+ * under the lock so the destructor can remove one that has not run yet.
+ */
+void BamfApplicationSource::Impl::
+desktop_entries_changed()
+{
+  std::lock_guard<std::mutex> lock(refresh_mutex_);
+  if (!refresh_source_)
+    refresh_source_ = g_idle_add(on_desktop_entries_changed, this);
+}
+
+
+gboolean BamfApplicationSource::Impl::
+on_desktop_entries_changed(gpointer data)
+{
+  BamfApplicationSource::Impl* impl = static_cast<BamfApplicationSource::Impl*>(data);
+  {
+    std::lock_guard<std::mutex> lock(impl->refresh_mutex_);
+    impl->refresh_source_ = 0;
+  }
+  impl->refresh_desktop_entries();
+  return FALSE;
+}
+
+
+/**
+ * Brings the metadata of the registered applications up to date with the
+ * desktop entry cache.
+ *
+ * The windows of an application whose metadata changed are reported again, so
+ * the wishes granted on them can follow.
+ */
+void BamfApplicationSource::Impl::
+refresh_desktop_entries()
+{
+  registry_.for_all_applications([this](Application* app)
+  {
+    std::string generic_name = desktop_entries_.generic_name(app->application_id());
+    if (generic_name == app->generic_name())
+      return;
+
+    app->set_generic_name(generic_name);
+    if (config_.is_verbose_mode())
+      std::cout << __FUNCTION__ << ": " << *app;
+    if (is_initialized_ && window_opened_callback_)
+      app->for_all_windows(window_opened_callback_);
+  });
 }
 
 
@@ -184,12 +287,7 @@ get_application(BamfApplication* bamf_app)
   }
   else
   {
-    auto it = std::find_if(std::begin(applications_),
-                           std::end(applications_),
-                           [&application_id](AppPtr const& app) -> bool
-                             { return app->application_id() == application_id; });
-    if (it != std::end(applications_))
-      app = it->get();
+    app = registry_.application(application_id);
   }
   return app;
 }
@@ -198,11 +296,10 @@ get_application(BamfApplication* bamf_app)
 Application* BamfApplicationSource::Impl::
 add_application(BamfApplication* bamf_app)
 {
-  AppPtr a(new Application(BamfApplicationBuilder(matcher_.get(), bamf_app)));
+  std::unique_ptr<Application> a(new Application(BamfApplicationBuilder(bamf_app, desktop_entries_)));
   if (config_.is_verbose_mode())
     std::cout << __FUNCTION__ << ": " << *a;
-  applications_.push_back(std::move(a));
-  return applications_.back().get();
+  return registry_.add_application(std::move(a));
 }
 
 
@@ -210,15 +307,20 @@ void BamfApplicationSource::Impl::
 remove_application(BamfApplication* bamf_app)
 {
   const gchar* application_id = bamf_application_get_desktop_file(bamf_app);
-  auto it = std::find_if(std::begin(applications_),
-                         std::end(applications_),
-                         [&application_id](AppPtr const& app) -> bool
-                           { return app->application_id() == application_id; });
-  if (it != std::end(applications_))
+  if (nullptr == application_id)
+    return;
+
+  Application const* app = registry_.application(application_id);
+  if (app)
   {
     if (config_.is_verbose_mode())
-      std::cout << __FUNCTION__ << ": \"" << (*it)->name() << "\" exited\n";
-    applications_.erase(it);
+      std::cout << __FUNCTION__ << ": \"" << app->name() << "\" exited\n";
+    registry_.remove_application(application_id, [this](Window const* w)
+    {
+      window_state_.unwatch(w->id_);
+      if (window_closed_callback_)
+        window_closed_callback_(w);
+    });
   }
 }
 
@@ -226,6 +328,10 @@ remove_application(BamfApplication* bamf_app)
 void BamfApplicationSource::Impl::
 add_window(BamfWindow* bamf_window)
 {
+  Window::Id window_id = bamf_window_get_xid(bamf_window);
+  if (registry_.window(window_id))
+    return;
+
   auto bamf_app = bamf_matcher_get_application_for_window(matcher_.get(), bamf_window);
   auto app = get_application(bamf_app);
   if (!app)
@@ -233,74 +339,209 @@ add_window(BamfWindow* bamf_window)
     app = add_application(bamf_app);
   }
 
+  window_state_.watch({window_id});
   char const* title = bamf_view_get_name(BAMF_VIEW(bamf_window));
-  Window* w = new Window {bamf_window_get_xid(bamf_window),
+  Window* w = new Window {window_id,
                           (title?title:"???"),
                           app,
                           (bool)bamf_view_is_active(BAMF_VIEW(bamf_window)),
-                          (bool)bamf_view_is_user_visible(BAMF_VIEW(bamf_window)),
+                          window_state_.is_on_screen(window_id),
                           bamf_window_get_monitor(bamf_window) };
-  app->add_window(std::unique_ptr<Window>(w));
+  if (!registry_.add_window(app, std::unique_ptr<Window>(w)))
+  {
+    window_state_.unwatch(window_id);
+    return;
+  }
 
-  if (window_opened_callback_)
+  g_signal_connect(G_OBJECT(bamf_window),
+                   "active-changed",
+                   (GCallback)on_window_state_changed,
+                   this);
+  if (is_initialized_ && window_opened_callback_)
     window_opened_callback_(w);
 }
 
 
 void BamfApplicationSource::Impl::
 remove_window(BamfWindow* bamf_window)
+{
+  g_signal_handlers_disconnect_by_data(G_OBJECT(bamf_window), this);
+  window_state_.unwatch(bamf_window_get_xid(bamf_window));
+  registry_.remove_window(bamf_window_get_xid(bamf_window), window_closed_callback_);
+}
+
+
+/**
+ * Picks up a change in a window's focus.
+ */
+void BamfApplicationSource::Impl::
+update_window(BamfWindow* bamf_window)
 {
   Window::Id window_id = bamf_window_get_xid(bamf_window);
-  for (auto const& app: applications_)
-  {
-    Window const* w = app->window(window_id);
-    if (w)
-    {
-      if (window_closed_callback_)
-      {
-        Window const* w = app->window(window_id);
-        window_closed_callback_(w);
-      }
-      app->remove_window(window_id);
-      break;
-    }
-  }
+  Window* w = registry_.window(window_id);
+  if (!w)
+    return;
+
+  update_window(w,
+                bamf_view_is_active(BAMF_VIEW(bamf_window)),
+                window_state_.is_on_screen(window_id));
+}
+
+
+/**
+ * Picks up a window being minimized, restored, or moving on or off the current
+ * workspace.
+ *
+ * BAMF's user-visible flag cannot be used for this:  it only says whether the
+ * window belongs in the task bar, which stays true for minimized windows and
+ * windows on other workspaces.
+ */
+void BamfApplicationSource::Impl::
+window_state_changed(Window::Id window_id)
+{
+  Window* w = registry_.window(window_id);
+  if (!w)
+    return;
+
+  update_window(w, w->is_active_, window_state_.is_on_screen(window_id));
+}
+
+
+void BamfApplicationSource::Impl::
+update_window(Window* w, bool is_active, bool is_visible)
+{
+  if (is_active == w->is_active_ && is_visible == w->is_visible_)
+    return;
+
+  w->is_active_ = is_active;
+  w->is_visible_ = is_visible;
+  if (window_changed_callback_)
+    window_changed_callback_(w);
+}
+
+
+BamfApplicationSource::Impl::
+~Impl()
+{
+  desktop_entries_.stop();
+  if (refresh_source_)
+    g_source_remove(refresh_source_);
+  if (initialization_source_)
+    g_source_remove(initialization_source_);
+  if (enumeration_source_)
+    g_source_remove(enumeration_source_);
+  for (auto bamf_window: pending_windows_)
+    g_object_unref(bamf_window);
 }
 
 
+/**
+ * Lists the windows of the running applications, most important first, to be
+ * registered a slice at a time.
+ *
+ * The focused window comes first, then the windows on screen, then the rest.
+ * All the windows start being watched for going on or off screen here, so
+ * their state is read in a single round trip.  Only the listing is done here; the Application and Window objects are built
+ * by enumerate_windows().  Running applications without windows are left to be
+ * registered when they open one.
+ */
 gboolean BamfApplicationSource::Impl::
 do_initialization(gpointer data)
 {
   BamfApplicationSource::Impl* impl = static_cast<BamfApplicationSource::Impl*>(data);
+  impl->initialization_source_ = 0;
+  std::vector<BamfWindow*> bamf_windows;
   GList* app_list = bamf_matcher_get_running_applications(impl->matcher_.get());
   for (GList* app = app_list; app; app = app->next)
   {
     if (!BAMF_IS_APPLICATION(app->data))
       continue;
 
-    auto a = impl->get_application(BAMF_APPLICATION(app->data));
-    if (!a)
-      a = impl->add_application(BAMF_APPLICATION(app->data));
-
     GList* window_list = bamf_application_get_windows(BAMF_APPLICATION(app->data));
     for (GList* window = window_list; window; window = window->next)
     {
       if (BAMF_IS_WINDOW(window->data))
       {
         auto bamf_window = static_cast<BamfWindow*>(window->data);
-        impl->add_window(bamf_window);
+        g_object_ref(bamf_window);
+        bamf_windows.push_back(bamf_window);
       }
     }
     g_list_free(window_list);
   }
   g_list_free(app_list);
 
-  if (impl->initialized_callback_)
-    impl->initialized_callback_();
+  std::vector<Window::Id> window_ids;
+  for (auto bamf_window: bamf_windows)
+    window_ids.push_back(bamf_window_get_xid(bamf_window));
+  impl->window_state_.watch(window_ids);
+
+  std::vector<std::pair<int, BamfWindow*>> windows;
+  for (auto bamf_window: bamf_windows)
+  {
+    int priority = bamf_view_is_active(BAMF_VIEW(bamf_window)) ? 0
+                 : impl->window_state_.is_on_screen(bamf_window_get_xid(bamf_window)) ? 1
+                 : 2;
+    windows.push_back({priority, bamf_window});
+  }
+
+  std::stable_sort(std::begin(windows), std::end(windows),
+                   [](std::pair<int, BamfWindow*> const& lhs,
+                      std::pair<int, BamfWindow*> const& rhs) -> bool
+                   { return lhs.first < rhs.first; });
+  for (auto const& window: windows)
+    impl->pending_windows_.push_back(window.second);
+
+  impl->enumeration_source_ = g_idle_add(enumerate_windows, impl);
   return false;
 }
 
 
+/**
+ * Registers the listed windows, yielding back to the main loop whenever a
+ * slice has taken its share of time.
+ *
+ * The source is initialized after the first slice, so the focused window is
+ * always in the first batch of windows reported.  The windows registered in
+ * later slices are reported as they are opened.
+ */
+gboolean BamfApplicationSource::Impl::
+enumerate_windows(gpointer data)
+{
+  BamfApplicationSource::Impl* impl = static_cast<BamfApplicationSource::Impl*>(data);
+  gint64 deadline = g_get_monotonic_time() + enumeration_slice_us;
+  while (!impl->pending_windows_.empty())
+  {
+    BamfWindow* bamf_window = impl->pending_windows_.front();
+    impl->pending_windows_.pop_front();
+    if (!bamf_view_is_closed(BAMF_VIEW(bamf_window)))
+      impl->add_window(bamf_window);
+    else
+      impl->window_state_.unwatch(bamf_window_get_xid(bamf_window));
+    g_object_unref(bamf_window);
+    if (g_get_monotonic_time() >= deadline)
+      break;
+  }
+
+  if (!impl->is_initialized_)
+  {
+    impl->is_initialized_ = true;
+    if (impl->config_.is_verbose_mode())
+      std::cout << __FUNCTION__ << ": " << impl->pending_windows_.size()
+                << " windows left to enumerate\n";
+    if (impl->initialized_callback_)
+      impl->initialized_callback_();
+  }
+
+  if (impl->pending_windows_.empty())
+  {
+    impl->enumeration_source_ = 0;
+    return false;
+  }
+  return true;
+}
+
+
 BamfApplicationSource::
 BamfApplicationSource(Configuration const& config)
 : impl_(new Impl(config))
@@ -336,17 +577,36 @@ set_window_closed_callback(WindowClosedCallback const& callback)
 }
 
 
+void BamfApplicationSource::
+set_window_changed_callback(WindowChangedCallback const& callback)
+{
+  impl_->window_changed_callback_ = callback;
+}
+
+
+/**
+ * The focused window is reported first, then the windows on screen, then the
+ * rest, so the windows the user is looking at get their wishes first.
+ */
 void BamfApplicationSource::
 report_windows()
 {
-  if (impl_->window_opened_callback_)
-  {
-    for (auto const& app: impl_->applications_)
-    {
-      app->for_all_windows([this](Window const* w)
-          { impl_->window_opened_callback_(w); });
-    }
-  }
+  if (!impl_->window_opened_callback_)
+    return;
+
+  std::vector<Window const*> windows;
+  windows.reserve(impl_->registry_.window_count());
+  impl_->registry_.for_all_windows([&windows](Window const* w)
+      { windows.push_back(w); });
+  std::stable_sort(std::begin(windows), std::end(windows),
+                   [](Window const* lhs, Window const* rhs) -> bool
+                   {
+                     if (lhs->is_active_ != rhs->is_active_)
+                       return lhs->is_active_;
+                     return lhs->is_visible_ && !rhs->is_visible_;
+                   });
+  for (auto w: windows)
+    impl_->window_opened_callback_(w);
 }
 
 } // namespace Ginn
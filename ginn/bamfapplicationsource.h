@@ -32,6 +32,11 @@ class Configuration;
 
 /**
  * A factory class to load Applications through BAMF.
+ *
+ * The windows already open at startup are enumerated in short slices on the
+ * main loop, the focused and on-screen windows first.  The source counts as
+ * initialized after the first slice; windows enumerated after that are
+ * reported as they are opened.
  */
 class BamfApplicationSource
 : public ApplicationSource
@@ -52,6 +57,9 @@ public:
   void
   set_window_closed_callback(WindowClosedCallback const& callback) override;
 
+  void
+  set_window_changed_callback(WindowChangedCallback const& callback) override;
+
   void
   report_windows() override;
 
@@ -0,0 +1,110 @@
+/**
+ * @file ginn/bundledwishsource.cpp
+ * @brief Definitions of the Ginn Bundled Wish Source class.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/bundledwishsource.h"
+
+#include "ginn/wishbundle.h"
+#include "ginn/wishsourceconfig.h"
+#include <iostream>
+
+
+namespace Ginn
+{
+
+BundledWishSource::
+BundledWishSource(WishSourceConfig const* config)
+: config_(config)
+{
+  if (config_->is_verbose_mode())
+    std::cout << __FUNCTION__ << " created for '"
+              << config_->wish_bundle_file_name() << "'\n";
+}
+
+
+BundledWishSource::
+~BundledWishSource()
+{ }
+
+
+Wish::Table BundledWishSource::
+get_wishes(RawSourceList const& raw_wishes)
+{
+  WishBundle bundle(config_->wish_bundle_file_name());
+  if (bundle.is_current_for(raw_wishes))
+  {
+    if (config_->is_verbose_mode())
+      std::cout << __FUNCTION__ << "(): loading wishes from bundle '"
+                << config_->wish_bundle_file_name() << "'\n";
+    return bundle.wishes();
+  }
+
+  if (config_->is_verbose_mode())
+    std::cout << __FUNCTION__ << "(): bundle '"
+              << config_->wish_bundle_file_name() << "' is not current\n";
+  WishSource* source = fallback();
+  return source ? source->get_wishes(raw_wishes) : Wish::Table();
+}
+
+
+WishSource::SourceWishes BundledWishSource::
+get_source_wishes(RawSourceList const& raw_wishes)
+{
+  WishBundle bundle(config_->wish_bundle_file_name());
+  if (bundle.is_current_for(raw_wishes))
+    return bundle.source_wishes();
+
+  WishSource* source = fallback();
+  return source ? source->get_source_wishes(raw_wishes) : SourceWishes();
+}
+
+
+/**
+ * Gets the wish source for reading the raw sources directly, creating it the
+ * first time it is needed.
+ */
+WishSource* BundledWishSource::
+fallback()
+{
+  if (!fallback_)
+    fallback_ = format_factory(config_);
+  return fallback_.get();
+}
+
+
+bool BundledWishSource::
+compile(WishSourceConfig const* config)
+{
+  Ptr source = format_factory(config);
+  if (!source)
+    return false;
+
+  RawSourceList raw_sources = read_raw_sources(config);
+  SourceWishes source_wishes = source->get_source_wishes(raw_sources);
+  if (!WishBundle::write(config->wish_bundle_file_name(), raw_sources, source_wishes))
+    return false;
+
+  if (config->is_verbose_mode())
+    std::cout << __FUNCTION__ << "(): compiled " << raw_sources.size()
+              << " sources into '" << config->wish_bundle_file_name() << "'\n";
+  return true;
+}
+
+} // namespace Ginn
+
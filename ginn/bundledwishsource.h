@@ -0,0 +1,70 @@
+/**
+ * @file ginn/bundledwishsource.h
+ * @brief Declarations of the Ginn Bundled Wish Source class.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_BUNDLEDWISHSOURCE_H_
+#define GINN_BUNDLEDWISHSOURCE_H_
+
+#include "ginn/wishsource.h"
+
+
+namespace Ginn
+{
+
+/**
+ * A wish source that loads wishes from a precompiled wish bundle.
+ *
+ * If the bundle is missing or was not compiled from the current raw sources,
+ * the wishes are loaded from the raw sources by a wish source for the
+ * configured format instead.  That source is only created when it is first
+ * needed, so a current bundle never touches the format's parser at all.
+ */
+class BundledWishSource
+: public WishSource
+{
+public:
+  BundledWishSource(WishSourceConfig const* config);
+  ~BundledWishSource();
+
+  Wish::Table
+  get_wishes(RawSourceList const& raw_wishes);
+
+  SourceWishes
+  get_source_wishes(RawSourceList const& raw_wishes);
+
+  /**
+   * Loads the wishes from the configured raw sources and compiles them into
+   * the configured bundle.
+   * @returns true if the bundle was written, false otherwise.
+   */
+  static bool
+  compile(WishSourceConfig const* config);
+
+private:
+  WishSource*
+  fallback();
+
+private:
+  WishSourceConfig const* config_;
+  Ptr                     fallback_;
+};
+
+} // namespace Ginn
+
+#endif // GINN_BUNDLEDWISHSOURCE_H_
@@ -195,6 +195,35 @@ find_wish_schema_file(std::string const& arg_wish_schema_file_name,
 }
 
 
+/**
+ * Chooses the name of the compiled wish bundle file.
+ *
+ * The bundle is a cache, so by default it lives under the XDG cache directory
+ * ($XDG_CACHE_HOME, default $HOME/.cache).
+ */
+static std::string
+find_wish_bundle_file(std::string const& arg_wish_bundle_file_name)
+{
+  if (!arg_wish_bundle_file_name.empty())
+    return arg_wish_bundle_file_name;
+
+  std::string cache_dir;
+  char const* xdg_cache_home = std::getenv("XDG_CACHE_HOME");
+  if (xdg_cache_home && *xdg_cache_home)
+  {
+    cache_dir = xdg_cache_home;
+  }
+  else
+  {
+    char const* home = std::getenv("HOME");
+    if (!home || !*home)
+      return std::string();
+    cache_dir = std::string(home) + "/.cache";
+  }
+  return cache_dir + "/" PACKAGE "/wishes.bundle";
+}
+
+
 namespace Ginn
 {
 
@@ -202,17 +231,25 @@ struct Configuration::Impl
 {
   Impl();
 
-  bool            is_verbose_mode;
-  ConfigPath      config_path;
-  std::string     wish_schema_file_name;
-  SourceNameList  wish_sources;
+  bool              is_verbose_mode;
+  bool              is_compile_mode;
+  ConfigPath        config_path;
+  std::string       arg_wish_file_name;
+  std::string       wish_schema_file_name;
+  std::string       wish_bundle_file_name;
+  SourceNameList    wish_sources;
+  ActionQueuePolicy action_queue_policy;
+  SubscriptionPolicy subscription_policy;
 };
 
 
 Configuration::Impl::
 Impl()
 : is_verbose_mode(false)
+, is_compile_mode(false)
 , config_path(config_search_path())
+, action_queue_policy(ActionQueuePolicy::coalesce)
+, subscription_policy(SubscriptionPolicy::eager)
 {
 }
 
@@ -235,6 +272,38 @@ print_version_and_exit()
 }
 
 
+/**
+ * Handles the --action-queue command-line switch.
+ */
+static ActionQueuePolicy
+to_action_queue_policy(std::string const& policy)
+{
+  if (policy == "drop-oldest")
+    return ActionQueuePolicy::drop_oldest;
+  if (policy == "block")
+    return ActionQueuePolicy::block;
+  if (policy != "coalesce")
+    std::cerr << "unrecognized action queue policy '" << policy << "', using 'coalesce'\n";
+  return ActionQueuePolicy::coalesce;
+}
+
+
+/**
+ * Handles the --subscriptions command-line switch.
+ */
+static SubscriptionPolicy
+to_subscription_policy(std::string const& policy)
+{
+  if (policy == "lazy")
+    return SubscriptionPolicy::lazy;
+  if (policy == "root")
+    return SubscriptionPolicy::root;
+  if (policy != "eager")
+    std::cerr << "unrecognized subscription policy '" << policy << "', using 'eager'\n";
+  return SubscriptionPolicy::eager;
+}
+
+
 /**
  * Handles the --help command-line switch.
  */
@@ -252,6 +321,14 @@ print_help_and_exit()
     "  -v, --verbose                    Keep a running commentary on stdout.\n"
     "  -f, --wishes-file=FILE           Name the (single) wish file to load.\n"
     "  -s, --wishes-schema-file=FILE    Name the wish schema file to load.\n"
+    "  -b, --wishes-bundle=FILE         Name the compiled wish bundle file.\n"
+    "  -c, --compile                    Compile the wishes into the bundle and exit.\n"
+    "  -q, --action-queue=POLICY        What to do when injected actions back up:\n"
+    "                                   drop-oldest, coalesce (default), or block.\n"
+    "  -u, --subscriptions=POLICY       When to subscribe to the gestures of granted\n"
+    "                                   wishes: eager (default), lazy (only for\n"
+    "                                   on-screen or focused windows), or root (once\n"
+    "                                   on the root window, for the focused app).\n"
     "\n";
   exit(-1);
 }
@@ -272,32 +349,49 @@ Configuration(int argc, char* argv[])
     arg_wish_file_name = env_wish_file;
 
   std::string arg_wish_schema_file_name;
+  std::string arg_wish_bundle_file_name;
 
   optind = 0; // see getopt(2)
   while (1)
   {
     int option_index = 0;
     static struct option long_options[] = {
+      { "action-queue",        required_argument, NULL, 'q' },
+      { "compile",             no_argument,       NULL, 'c' },
       { "help",                no_argument,       NULL, 'h' },
       { "novalidate",          no_argument,       NULL, 'n' },
+      { "subscriptions",       required_argument, NULL, 'u' },
       { "wishes-schema-file",  required_argument, NULL, 's' },
       { "verbose",             no_argument,       NULL, 'v' },
       { "version",             no_argument,       NULL, 'V' },
+      { "wishes-bundle",       required_argument, NULL, 'b' },
       { "wishes-file",         required_argument, NULL, 'f' },
       { 0,                     no_argument,       NULL,  0  }
     };
 
-    int c = getopt_long(argc, argv, "f:hr:v", long_options, &option_index);
+    int c = getopt_long(argc, argv, "b:cf:hq:r:u:v", long_options, &option_index);
     if (c == -1)
       break;
 
     switch (c) {
+      case 'b':
+        arg_wish_bundle_file_name = optarg;
+        break;
+      case 'c':
+        impl_->is_compile_mode = true;
+        break;
       case 'f':
         arg_wish_file_name = optarg;
         break;
       case 's':
         arg_wish_schema_file_name = optarg;
         break;
+      case 'q':
+        impl_->action_queue_policy = to_action_queue_policy(optarg);
+        break;
+      case 'u':
+        impl_->subscription_policy = to_subscription_policy(optarg);
+        break;
       case 'v':
         impl_->is_verbose_mode = true;
         break;
@@ -313,9 +407,11 @@ Configuration(int argc, char* argv[])
     }
   }
 
+  impl_->arg_wish_file_name = arg_wish_file_name;
   impl_->wish_sources = find_wish_sources(arg_wish_file_name, impl_->config_path);
   impl_->wish_schema_file_name = find_wish_schema_file(arg_wish_schema_file_name,
                                                        impl_->config_path);
+  impl_->wish_bundle_file_name = find_wish_bundle_file(arg_wish_bundle_file_name);
 
   if (is_verbose_mode())
     print_version();
@@ -351,12 +447,78 @@ wish_sources() const
 }
 
 
+WishSourceConfig::SourceNameList Configuration::
+scan_wish_sources() const
+{
+  return find_wish_sources(impl_->arg_wish_file_name, impl_->config_path);
+}
+
+
+/**
+ * Lists the directories searched for wish definition files.
+ *
+ * These are the ginn directories and their wishes.d subdirectories on the
+ * config path, whether they exist yet or not, or just the directory of the
+ * wish file named on the command line.
+ */
+WishSourceConfig::SourceNameList Configuration::
+wish_source_directories() const
+{
+  SourceNameList directories;
+  if (!impl_->arg_wish_file_name.empty())
+  {
+    std::string::size_type slash = impl_->arg_wish_file_name.rfind('/');
+    if (slash == std::string::npos)
+      directories.push_back(".");
+    else
+      directories.push_back(impl_->arg_wish_file_name.substr(0, slash ? slash : 1));
+    return directories;
+  }
+
+  for (auto const& d: impl_->config_path)
+  {
+    std::string refdir = d + "/" PACKAGE;
+    directories.push_back(refdir);
+    directories.push_back(refdir + "/wishes.d");
+  }
+  return directories;
+}
+
+
 std::string const& Configuration::
 wish_schema_file_name() const
 {
   return impl_->wish_schema_file_name;
 }
 
+
+std::string const& Configuration::
+wish_bundle_file_name() const
+{
+  return impl_->wish_bundle_file_name;
+}
+
+
+bool Configuration::
+is_compile_mode() const
+{
+  return impl_->is_compile_mode;
+}
+
+
+ActionQueuePolicy Configuration::
+action_queue_policy() const
+{
+  return impl_->action_queue_policy;
+}
+
+
+SubscriptionPolicy Configuration::
+subscription_policy() const
+{
+  return impl_->subscription_policy;
+}
+
 } // namespace Ginn
 
 
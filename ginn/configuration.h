@@ -22,6 +22,7 @@
 #define GINN_CONFIGURATION_H_
 
 #include "ginn/applicationsource.h"
+#include "ginn/policies.h"
 #include "ginn/wishsourceconfig.h"
 #include <memory>
 #include <string>
@@ -53,10 +54,34 @@ public:
   SourceNameList const&
   wish_sources() const override;
 
+  /** Searches for the files containing wish definitions again. */
+  SourceNameList
+  scan_wish_sources() const;
+
+  /** Gets the directories in which wish definition files may change. */
+  SourceNameList
+  wish_source_directories() const;
+
   /** Gets the name of the wish schema file. */
   std::string const&
   wish_schema_file_name() const override;
 
+  /** Gets the name of the compiled wish bundle file. */
+  std::string const&
+  wish_bundle_file_name() const override;
+
+  /** Indicates the wishes should be compiled into the bundle and nothing else. */
+  bool
+  is_compile_mode() const;
+
+  /** Gets what to do when the action injection queue overflows. */
+  ActionQueuePolicy
+  action_queue_policy() const;
+
+  /** Gets when the gesture subscriptions of granted wishes are made. */
+  SubscriptionPolicy
+  subscription_policy() const;
+
 private:
   struct Impl;
 
@@ -0,0 +1,489 @@
+/**
+ * @file ginn/desktopentrycache.cpp
+ * @brief Definitions of the Ginn Desktop Entry Cache module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/desktopentrycache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <sys/stat.h>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+
+namespace Ginn
+{
+
+namespace
+{
+
+/**
+ * The metadata kept for a desktop file.
+ */
+struct DesktopEntry
+{
+  std::time_t mtime;         ///< modification time of the file when read
+  std::string generic_name;  ///< the best-matching localized GenericName key
+};
+
+
+/**
+ * Splits a colon-separated search path.
+ */
+void
+append_path(std::string const& path, DesktopEntryCache::DirectoryList& dirs)
+{
+  std::string::size_type p = 0;
+  std::string::size_type n = path.find(':');
+  while (n != std::string::npos)
+  {
+    if (n > p)
+      dirs.push_back(path.substr(p, n-p) + "/applications");
+    p = n+1, n = path.find(':', p);
+  }
+  if (p < path.size())
+    dirs.push_back(path.substr(p) + "/applications");
+}
+
+
+/**
+ * Gets the locale suffixes a localized key may have for a message locale, most
+ * specific first.
+ *
+ * Following the desktop entry spec, a locale of the form
+ * lang_COUNTRY.ENCODING@MODIFIER matches lang_COUNTRY@MODIFIER, lang_COUNTRY,
+ * lang@MODIFIER, and lang, in that order.  The encoding is ignored.  The C and
+ * POSIX locales match no localized keys at all.
+ */
+DesktopEntryCache::LocaleList
+locale_variants(std::string const& locale)
+{
+  DesktopEntryCache::LocaleList variants;
+  if (locale.empty() || locale == "C" || locale == "POSIX")
+    return variants;
+
+  std::string::size_type at = locale.find('@');
+  std::string modifier = (at == std::string::npos) ? "" : locale.substr(at);
+  std::string lang_country = locale.substr(0, std::min(at, locale.find('.')));
+  std::string::size_type underscore = lang_country.find('_');
+  std::string lang = lang_country.substr(0, underscore);
+
+  if (underscore != std::string::npos)
+  {
+    if (!modifier.empty())
+      variants.push_back(lang_country + modifier);
+    variants.push_back(lang_country);
+  }
+  if (!modifier.empty())
+    variants.push_back(lang + modifier);
+  variants.push_back(lang);
+  return variants;
+}
+
+
+/**
+ * Reads the metadata out of a desktop file.
+ * @param[in] desktop_file  The path of the desktop file.
+ * @param[in] mtime         The modification time of the file.
+ * @param[in] locales       The acceptable locale suffixes, most specific first.
+ *
+ * Only the [Desktop Entry] group is looked at.  The value of a localized key
+ * for the most specific matching locale is used, falling back to the
+ * unlocalized key, which is how GDesktopAppInfo picks them too.
+ */
+DesktopEntry
+read_desktop_entry(std::string const&                    desktop_file,
+                   std::time_t                           mtime,
+                   DesktopEntryCache::LocaleList const&  locales)
+{
+  static const std::string generic_name_key = "GenericName";
+
+  DesktopEntry entry{mtime, ""};
+  std::size_t best_rank = locales.size() + 1;
+  std::ifstream file(desktop_file);
+  bool in_desktop_entry = false;
+  std::string line;
+  while (std::getline(file, line))
+  {
+    if (line.empty() || line[0] == '#')
+      continue;
+    if (line[0] == '[')
+    {
+      if (in_desktop_entry)
+        break;
+      in_desktop_entry = (line.compare(0, 15, "[Desktop Entry]") == 0);
+      continue;
+    }
+    if (!in_desktop_entry)
+      continue;
+
+    std::string::size_type eq = line.find('=');
+    if (eq == std::string::npos || eq == 0)
+      continue;
+    std::string::size_type key_end = line.find_last_not_of(" \t", eq - 1);
+    if (key_end == std::string::npos)
+      continue;
+    if (line.compare(0, generic_name_key.size(), generic_name_key) != 0)
+      continue;
+
+    std::size_t rank = best_rank;
+    if (key_end + 1 == generic_name_key.size())
+    {
+      rank = locales.size();
+    }
+    else if (line[generic_name_key.size()] == '[' && line[key_end] == ']')
+    {
+      std::string locale = line.substr(generic_name_key.size() + 1,
+                                       key_end - generic_name_key.size() - 1);
+      rank = std::find(locales.begin(), locales.end(), locale) - locales.begin();
+      if (rank == locales.size())
+        continue;
+    }
+    if (rank >= best_rank)
+      continue;
+
+    std::string::size_type value = line.find_first_not_of(" \t", eq + 1);
+    entry.generic_name = (value == std::string::npos) ? "" : line.substr(value);
+    best_rank = rank;
+  }
+  return entry;
+}
+
+} // anonymous namespace
+
+
+/** How often the worker scans the application directories again. */
+static const std::chrono::seconds rescan_interval(60);
+
+
+struct DesktopEntryCache::Impl
+{
+  Impl(std::string const& locale)
+  : locales_(locale_variants(locale))
+  , stop_(false)
+  , rescan_requested_(false)
+  , is_busy_(false)
+  { }
+
+  void
+  run();
+
+  bool
+  scan_directory(std::string const& dir_name, int depth);
+
+  bool
+  scan_file(std::string const& file_name, std::time_t mtime);
+
+  bool
+  check_file(std::string const& file_name);
+
+  LocaleList                                    locales_;
+  mutable std::mutex                            mutex_;
+  std::unordered_map<std::string, DesktopEntry> entries_;
+  DirectoryList                                 directories_;
+  ChangedCallback                               changed_callback_;
+  std::vector<std::string>                      queued_files_;
+  std::set<std::string>                         extra_files_;
+  std::condition_variable                       work_;
+  std::condition_variable                       idle_;
+  std::thread                                   worker_;
+  std::atomic<bool>                             stop_;
+  bool                                          rescan_requested_;
+  bool                                          is_busy_;
+};
+
+
+/**
+ * The worker thread:  scans the directories when asked to or when the rescan
+ * interval has passed, and reads the files queued by lookups in between.
+ *
+ * A scan also checks the files read on request that live outside the scanned
+ * directories.  Nothing is read with the lock held, so lookups never wait on
+ * file I/O.
+ */
+void DesktopEntryCache::Impl::
+run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_)
+  {
+    bool is_rescan = rescan_requested_;
+    rescan_requested_ = false;
+    DirectoryList directories = directories_;
+    std::vector<std::string> files;
+    files.swap(queued_files_);
+    if (is_rescan)
+      files.insert(std::end(files), std::begin(extra_files_), std::end(extra_files_));
+    ChangedCallback changed_callback = changed_callback_;
+    lock.unlock();
+
+    bool changed = false;
+    if (is_rescan)
+    {
+      for (auto const& dir: directories)
+        changed |= scan_directory(dir, 0);
+    }
+    for (auto const& file: files)
+      changed |= check_file(file);
+    if (changed && changed_callback && !stop_)
+      changed_callback();
+
+    lock.lock();
+    if (queued_files_.empty() && !rescan_requested_)
+    {
+      is_busy_ = false;
+      idle_.notify_all();
+      if (!work_.wait_for(lock, rescan_interval,
+                          [this]() { return stop_ || rescan_requested_ || !queued_files_.empty(); }))
+        rescan_requested_ = true;
+      is_busy_ = true;
+    }
+  }
+  is_busy_ = false;
+  idle_.notify_all();
+}
+
+
+/**
+ * Scans a directory for desktop files, including its subdirectories (whose
+ * desktop files have vendor-prefixed ids, but are still found by path).
+ * @returns true if any cached metadata changed.
+ */
+bool DesktopEntryCache::Impl::
+scan_directory(std::string const& dir_name, int depth)
+{
+  static const int max_depth = 4;
+  DIR* dir = opendir(dir_name.c_str());
+  if (!dir)
+    return false;
+
+  bool changed = false;
+  for (struct dirent* de = readdir(dir); de && !stop_; de = readdir(dir))
+  {
+    if (de->d_name[0] == '.')
+      continue;
+
+    std::string file_name = dir_name + "/" + de->d_name;
+    struct stat f_stat;
+    if (0 != stat(file_name.c_str(), &f_stat))
+      continue;
+    if (S_ISDIR(f_stat.st_mode))
+    {
+      if (depth < max_depth)
+        changed |= scan_directory(file_name, depth + 1);
+    }
+    else if (S_ISREG(f_stat.st_mode))
+    {
+      std::size_t len = std::strlen(de->d_name);
+      if (len > 8 && 0 == std::strcmp(de->d_name + len - 8, ".desktop"))
+        changed |= scan_file(file_name, f_stat.st_mtime);
+    }
+  }
+  closedir(dir);
+  return changed;
+}
+
+
+/**
+ * Reads a desktop file unless it is already cached and has not changed.
+ * @returns true if what a lookup of the file gives has changed.
+ */
+bool DesktopEntryCache::Impl::
+scan_file(std::string const& file_name, std::time_t mtime)
+{
+  std::string old_generic_name;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(file_name);
+    if (it != std::end(entries_))
+    {
+      if (it->second.mtime == mtime)
+        return false;
+      old_generic_name = it->second.generic_name;
+    }
+  }
+
+  DesktopEntry entry = read_desktop_entry(file_name, mtime, locales_);
+  bool changed = (entry.generic_name != old_generic_name);
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_[file_name] = std::move(entry);
+  return changed;
+}
+
+
+/**
+ * Reads a desktop file asked for by a lookup, if it has changed.  A file that
+ * does not exist is cached with no metadata.
+ */
+bool DesktopEntryCache::Impl::
+check_file(std::string const& file_name)
+{
+  struct stat f_stat;
+  std::time_t mtime = (0 == stat(file_name.c_str(), &f_stat)) ? f_stat.st_mtime : 0;
+  return scan_file(file_name, mtime);
+}
+
+
+DesktopEntryCache::
+DesktopEntryCache(std::string const& locale)
+: impl_(new Impl(locale))
+{
+  impl_->worker_ = std::thread(&Impl::run, impl_.get());
+}
+
+
+DesktopEntryCache::
+~DesktopEntryCache()
+{
+  stop();
+}
+
+
+/**
+ * The application directories are $XDG_DATA_HOME (default $HOME/.local/share)
+ * followed by $XDG_DATA_DIRS (default /usr/local/share:/usr/share), each with
+ * "/applications" appended.
+ */
+DesktopEntryCache::DirectoryList DesktopEntryCache::
+application_directories()
+{
+  DirectoryList dirs;
+
+  char const* xdg_data_home = std::getenv("XDG_DATA_HOME");
+  if (xdg_data_home && *xdg_data_home)
+  {
+    dirs.push_back(std::string(xdg_data_home) + "/applications");
+  }
+  else
+  {
+    char const* home = std::getenv("HOME");
+    if (home && *home)
+      dirs.push_back(std::string(home) + "/.local/share/applications");
+  }
+
+  char const* xdg_data_dirs = std::getenv("XDG_DATA_DIRS");
+  if (0 == xdg_data_dirs || 0 == *xdg_data_dirs)
+    xdg_data_dirs = "/usr/local/share:/usr/share";
+  append_path(xdg_data_dirs, dirs);
+  return dirs;
+}
+
+
+void DesktopEntryCache::
+start_scan(DirectoryList const& directories, ChangedCallback const& changed)
+{
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
+  impl_->directories_ = directories;
+  impl_->changed_callback_ = changed;
+  impl_->rescan_requested_ = true;
+  impl_->is_busy_ = true;
+  impl_->work_.notify_one();
+}
+
+
+void DesktopEntryCache::
+rescan()
+{
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
+  impl_->rescan_requested_ = true;
+  impl_->is_busy_ = true;
+  impl_->work_.notify_one();
+}
+
+
+void DesktopEntryCache::
+wait_for_scan()
+{
+  std::unique_lock<std::mutex> lock(impl_->mutex_);
+  impl_->idle_.wait(lock, [this]() { return !impl_->is_busy_; });
+}
+
+
+void DesktopEntryCache::
+stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->stop_ = true;
+    impl_->work_.notify_one();
+  }
+  if (impl_->worker_.joinable())
+    impl_->worker_.join();
+}
+
+
+/**
+ * The locale is the first one set of $LC_ALL, $LC_MESSAGES, and $LANG.
+ */
+std::string DesktopEntryCache::
+message_locale()
+{
+  for (char const* name: { "LC_ALL", "LC_MESSAGES", "LANG" })
+  {
+    char const* locale = std::getenv(name);
+    if (locale && *locale)
+      return locale;
+  }
+  return "";
+}
+
+
+/**
+ * A desktop file that is not cached yet is queued for the worker to read, and
+ * gets looked up again once the changed callback says it has been.
+ */
+std::string DesktopEntryCache::
+generic_name(std::string const& desktop_file)
+{
+  if (desktop_file.empty())
+    return "";
+
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
+  auto it = impl_->entries_.find(desktop_file);
+  if (it != std::end(impl_->entries_))
+    return it->second.generic_name;
+
+  if (impl_->extra_files_.insert(desktop_file).second)
+  {
+    impl_->queued_files_.push_back(desktop_file);
+    impl_->is_busy_ = true;
+    impl_->work_.notify_one();
+  }
+  return "";
+}
+
+
+std::size_t DesktopEntryCache::
+size() const
+{
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
+  return impl_->entries_.size();
+}
+
+} // namespace Ginn
@@ -0,0 +1,116 @@
+/**
+ * @file ginn/desktopentrycache.h
+ * @brief Declarations of the Ginn Desktop Entry Cache module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_DESKTOPENTRYCACHE_H_
+#define GINN_DESKTOPENTRYCACHE_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace Ginn
+{
+
+/**
+ * A cache of the metadata Ginn uses from desktop entry (.desktop) files.
+ *
+ * All file I/O happens on a background worker thread, so looking up an
+ * application's metadata on the main loop is just a hash lookup.  The worker
+ * scans the XDG application directories, then scans them again every so often
+ * to pick up changed desktop files.  Entries are keyed by the path of the
+ * desktop file and remember its modification time, so scanning again only
+ * re-reads the files that changed.
+ *
+ * Looking up a desktop file that has not been cached yet (it lives outside the
+ * scanned directories or the scan has not reached it yet) gives an empty
+ * result and queues the file to be read by the worker.  The worker reports
+ * whenever the cached metadata has changed, so the caller can look it up
+ * again.
+ *
+ * Localized keys are matched against the message locale the cache was created
+ * with.
+ */
+class DesktopEntryCache
+{
+public:
+  using DirectoryList = std::vector<std::string>;
+  using LocaleList = std::vector<std::string>;
+  /** Called on the worker thread when some cached metadata has changed. */
+  using ChangedCallback = std::function<void()>;
+
+public:
+  explicit
+  DesktopEntryCache(std::string const& locale = message_locale());
+
+  ~DesktopEntryCache();
+
+  /**
+   * Gets the application directories of the XDG base directory spec, most
+   * important first.
+   */
+  static DirectoryList
+  application_directories();
+
+  /** Gets the locale used for messages, according to the environment. */
+  static std::string
+  message_locale();
+
+  /**
+   * Starts scanning a list of directories for desktop files in the background,
+   * and keeps rescanning them from time to time.
+   */
+  void
+  start_scan(DirectoryList const&    directories,
+             ChangedCallback const&  changed = ChangedCallback());
+
+  /** Asks the worker to scan again right away. */
+  void
+  rescan();
+
+  /** Waits until the worker has no scanning or reading left to do. */
+  void
+  wait_for_scan();
+
+  /** Stops the worker, waiting for it to finish what it is doing. */
+  void
+  stop();
+
+  /**
+   * Gets the localized GenericName of a desktop file, or an empty string if
+   * the file has not been cached yet.
+   */
+  std::string
+  generic_name(std::string const& desktop_file);
+
+  /** Gets the number of cached desktop files. */
+  std::size_t
+  size() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace Ginn
+
+#endif // GINN_DESKTOPENTRYCACHE_H_
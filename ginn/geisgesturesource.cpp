@@ -20,22 +20,57 @@
  */
 #include "ginn/geisgesturesource.h"
 
+#include <array>
 #include <geis/geis.h>
 #include "ginn/configuration.h"
+#include "ginn/property.h"
 #include <glib.h>
 #include <iostream>
 #include <map>
 #include <stdexcept>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 
 namespace Ginn
 {
 
+/** Maps gesture class names to GEIS gesture classes. */
+using GeisClassMap = std::map<std::string, GeisGestureClass>;
+
+
+/**
+ * A gesture event as received from GEIS.
+ *
+ * The GEIS frames get unpacked once, when the event is constructed:  the window
+ * ID, touch count, and the value of every interned trigger property are copied
+ * into fixed-size storage so there are no further string-keyed attribute
+ * searches and no heap allocations while matching wishes.  The rare event with
+ * more frames than fit spills the rest onto the heap rather than losing them.
+ */
 struct GeisGestureEvent
 : public GestureEvent
 {
-  GeisGestureEvent(GeisEvent geis_event)
+  /** The number of frames (target windows) kept without allocating. */
+  static const std::size_t max_frames = 16;
+
+  /** The part of a GEIS gesture event delivered to a single window. */
+  struct Frame
+  {
+    Window::Id        window_id_;
+    GeisFrame         frame_;
+    int               touches_;
+    PropertySnapshot  properties_;
+  };
+
+  GeisGestureEvent(GeisEvent           geis_event,
+                   GesturePhase        phase,
+                   GeisClassMap const& class_map)
+  : phase_(phase)
+  , class_map_(class_map)
+  , frame_count_(0)
   {
     GeisAttr attr = geis_event_attr_by_name(geis_event, GEIS_EVENT_ATTRIBUTE_GROUPSET);
     GeisGroupSet groupset = static_cast<GeisGroupSet>(geis_attr_value_to_pointer(attr));
@@ -48,44 +83,134 @@ struct GeisGestureEvent
         attr = geis_frame_attr_by_name(frame, GEIS_GESTURE_ATTRIBUTE_EVENT_WINDOW_ID);
         if (attr)
         {
-          Window::Id id = geis_attr_value_to_integer(attr);
-          frames_[id] = frame;
+          if (frame_count_ >= max_frames)
+            overflow_.emplace_back();
+          Frame& f = frame_at(frame_count_++);
+          f.window_id_ = geis_attr_value_to_integer(attr);
+          f.frame_ = frame;
+          GeisAttr touches = geis_frame_attr_by_name(frame, GEIS_GESTURE_ATTRIBUTE_TOUCHES);
+          f.touches_ = touches ? geis_attr_value_to_integer(touches) : 0;
+          take_snapshot(frame, f.properties_);
         }
       }
     }
   }
 
-  bool
-  matches(Window const* window, Wish::Ptr const& wish) const
+  /**
+   * Copies the values of all interned properties out of a GEIS frame.
+   */
+  static void
+  take_snapshot(GeisFrame frame, PropertySnapshot& snapshot)
   {
-    if (frames_.find(window->id_) != frames_.end())
+    for (std::size_t id = 0; id < Property::count(); ++id)
     {
-      GeisFrame frame = frames_.at(window->id_);
-      GeisAttr attr = geis_frame_attr_by_name(frame, wish->property().c_str());
-      if (attr)
+      GeisAttr attr = geis_frame_attr_by_name(frame, Property::name(id).c_str());
+      if (!attr)
+        continue;
+
+      switch (geis_attr_type(attr))
       {
-          float fval = geis_attr_value_to_float(attr);
-          return wish->min() <= fval && fval <= wish->max();
+        case GEIS_ATTR_TYPE_FLOAT:
+          snapshot.set(id, geis_attr_value_to_float(attr));
+          break;
+        case GEIS_ATTR_TYPE_INTEGER:
+          snapshot.set(id, static_cast<float>(geis_attr_value_to_integer(attr)));
+          break;
+        case GEIS_ATTR_TYPE_BOOLEAN:
+          snapshot.set(id, geis_attr_value_to_boolean(attr) ? 1.0f : 0.0f);
+          break;
+        default:
+          break;
       }
     }
-    return false;
   }
 
-  std::map<Window::Id, GeisFrame> frames_;
+  Frame&
+  frame_at(std::size_t frame)
+  { return frame < max_frames ? frames_[frame] : overflow_[frame - max_frames]; }
+
+  Frame const&
+  frame_at(std::size_t frame) const
+  { return frame < max_frames ? frames_[frame] : overflow_[frame - max_frames]; }
+
+  GesturePhase
+  phase() const
+  { return phase_; }
+
+  std::size_t
+  frame_count() const
+  { return frame_count_; }
+
+  Window::Id
+  window_id(std::size_t frame) const
+  { return frame_at(frame).window_id_; }
+
+  bool
+  is_gesture(std::size_t frame, std::string const& gesture, int touches) const
+  {
+    if (frame_at(frame).touches_ != touches)
+      return false;
+    auto it = class_map_.find(gesture);
+    return it != class_map_.end()
+        && geis_frame_is_class(frame_at(frame).frame_, it->second);
+  }
+
+  GestureId
+  gesture_id(std::size_t frame) const
+  { return geis_frame_id(frame_at(frame).frame_); }
+
+  PropertySnapshot const&
+  properties(std::size_t frame) const
+  { return frame_at(frame).properties_; }
+
+  GesturePhase                   phase_;
+  GeisClassMap const&            class_map_;
+  std::size_t                    frame_count_;
+  std::array<Frame, max_frames>  frames_;
+  std::vector<Frame>             overflow_;
 };
 
 
+/**
+ * Identifies a GEIS subscription shared by all wishes on the same window for
+ * the same gesture class and touch count.
+ */
+using SubscriptionKey = std::tuple<Window::Id, std::string, int>;
+
+/** A GEIS subscription, its filter, and the number of wishes sharing it. */
+struct SharedSubscription
+{
+  GeisSubscription geis_sub_;
+  GeisFilter       filter_;
+  int              ref_count_;
+};
+
+/** The active GEIS subscriptions. */
+using SubscriptionMap = std::map<SubscriptionKey, SharedSubscription>;
+
+/** Identifies the gesture class and touch count part of a GEIS filter. */
+using ClassFilterKey = std::pair<std::string, int>;
+
+/** Filters with only the gesture class terms, cloned for each window. */
+using ClassFilterMap = std::map<ClassFilterKey, GeisFilter>;
+
+
+/**
+ * A wish's reference to a shared GEIS subscription.
+ */
 struct GeisGestureSubscription
 : public GestureSubscription
 {
-  GeisGestureSubscription(GeisSubscription geis_sub)
-  : geis_sub_(geis_sub)
+  GeisGestureSubscription(GeisGestureSource::Impl* impl,
+                          SubscriptionMap::iterator shared_sub)
+  : impl_(impl)
+  , shared_sub_(shared_sub)
   { }
 
-  ~GeisGestureSubscription()
-  { }
+  ~GeisGestureSubscription();
 
-  GeisSubscription geis_sub_;
+  GeisGestureSource::Impl*  impl_;
+  SubscriptionMap::iterator shared_sub_;
 };
 
 
@@ -94,15 +219,41 @@ struct GeisGestureSource::Impl
   Impl(Configuration const& config);
   ~Impl();
 
+  void
+  dispatch_gesture_event(GeisEvent geis_event, GesturePhase phase);
+
+  SubscriptionMap::iterator
+  acquire_subscription(Window::Id window_id, Wish const& wish);
+
+  void
+  release_subscription(SubscriptionMap::iterator shared_sub);
+
+  GeisFilter
+  new_window_filter(Window::Id window_id, Wish const& wish);
+
+  /** The most deactivated GEIS subscriptions kept around for reuse. */
+  static const std::size_t max_idle_subscriptions = 16;
+
   Configuration                            config_;
   ::Geis                                   geis_;
   GestureSource::EventReceivedCallback     event_received_callback_;
   GestureSource::InitializedCallback       initialized_callback_;
   GIOChannel*                              iochannel_;
-  std::map<std::string, GeisGestureClass>  class_map_;
+  GeisClassMap                             class_map_;
+  SubscriptionMap                          subscriptions_;
+  ClassFilterMap                           class_filters_;
+  std::vector<GeisSubscription>            idle_subscriptions_;
+  unsigned int                             subscription_serial_;
 };
 
 
+GeisGestureSubscription::
+~GeisGestureSubscription()
+{
+  impl_->release_subscription(shared_sub_);
+}
+
+
 /**
  * GIO event handler callback, passes GEIS events on to GEIS.
  */
@@ -150,14 +301,16 @@ geis_gesture_event_ready(::Geis, GeisEvent geis_event, void* context)
       break;
 
     case GEIS_EVENT_GESTURE_BEGIN:
+      impl->dispatch_gesture_event(geis_event, GesturePhase::begin);
+      break;
+
     case GEIS_EVENT_GESTURE_UPDATE:
+      impl->dispatch_gesture_event(geis_event, GesturePhase::update);
+      break;
+
     case GEIS_EVENT_GESTURE_END:
-    {
-      GeisGestureEvent gesture_event(geis_event);
-      if (impl->event_received_callback_)
-        impl->event_received_callback_(gesture_event);
+      impl->dispatch_gesture_event(geis_event, GesturePhase::end);
       break;
-    }
 
     default:
       break;
@@ -170,6 +323,7 @@ GeisGestureSource::Impl::
 Impl(Configuration const& config)
 : config_(config)
 , geis_(geis_new(GEIS_INIT_TRACK_DEVICES, GEIS_INIT_TRACK_GESTURE_CLASSES, NULL))
+, subscription_serial_(0)
 {
   if (!geis_)
     throw std::runtime_error("could not create GEIS instance");
@@ -185,9 +339,134 @@ Impl(Configuration const& config)
 }
 
 
+/**
+ * Passes a GEIS gesture event on to whoever is listening for gesture events.
+ */
+void GeisGestureSource::Impl::
+dispatch_gesture_event(GeisEvent geis_event, GesturePhase phase)
+{
+  if (event_received_callback_)
+  {
+    GeisGestureEvent gesture_event(geis_event, phase, class_map_);
+    event_received_callback_(gesture_event);
+  }
+}
+
+
+/**
+ * Gets a reference to the GEIS subscription for a wish on a window, creating
+ * it if this is the first wish on the window for its gesture class and touch
+ * count.
+ *
+ * GEIS evaluates and delivers each frame once per matching subscription, so
+ * sharing them keeps a window with many wishes from getting the same frame
+ * many times over.  Fanning the frame out to the wishes is left to the
+ * in-process dispatch.
+ */
+SubscriptionMap::iterator GeisGestureSource::Impl::
+acquire_subscription(Window::Id window_id, Wish const& wish)
+{
+  SubscriptionKey key{window_id, wish.gesture(), wish.touches()};
+  auto it = subscriptions_.find(key);
+  if (it != std::end(subscriptions_))
+  {
+    ++it->second.ref_count_;
+    return it;
+  }
+
+  GeisSubscription geis_sub;
+  if (idle_subscriptions_.empty())
+  {
+    std::string name = "ginn-" + std::to_string(subscription_serial_++);
+    geis_sub = geis_subscription_new(geis_, name.c_str(), GEIS_SUBSCRIPTION_CONT);
+  }
+  else
+  {
+    geis_sub = idle_subscriptions_.back();
+    idle_subscriptions_.pop_back();
+  }
+  GeisFilter filter = new_window_filter(window_id, wish);
+  geis_subscription_add_filter(geis_sub, filter);
+  geis_subscription_activate(geis_sub);
+
+  if (config_.is_verbose_mode())
+    std::cout << __PRETTY_FUNCTION__ << " subscribed to " << wish.gesture()
+              << wish.touches() << " on window " << window_id << "\n";
+
+  return subscriptions_.emplace(key, SharedSubscription{geis_sub, filter, 1}).first;
+}
+
+
+/**
+ * Drops a reference to a shared GEIS subscription, deactivating it when the
+ * last wish using it has been revoked.
+ *
+ * The window filter is removed (which frees it) and the bare subscription is
+ * kept for reuse, up to a limit, since windows tend to come and go in bursts.
+ */
+void GeisGestureSource::Impl::
+release_subscription(SubscriptionMap::iterator shared_sub)
+{
+  if (--shared_sub->second.ref_count_ > 0)
+    return;
+
+  GeisSubscription geis_sub = shared_sub->second.geis_sub_;
+  geis_subscription_deactivate(geis_sub);
+  geis_subscription_remove_filter(geis_sub, shared_sub->second.filter_);
+  if (idle_subscriptions_.size() < max_idle_subscriptions)
+    idle_subscriptions_.push_back(geis_sub);
+  else
+    geis_subscription_delete(geis_sub);
+  subscriptions_.erase(shared_sub);
+}
+
+
+/**
+ * Creates a filter for a wish's gesture class and touch count on a window.
+ *
+ * The class terms are the same for every window, so they are built once into
+ * a template filter that gets cloned and has just the window term added.  A
+ * filter for the root window gets no window term, so the gesture is delivered
+ * wherever it happens.
+ */
+GeisFilter GeisGestureSource::Impl::
+new_window_filter(Window::Id window_id, Wish const& wish)
+{
+  ClassFilterKey class_key{wish.gesture(), wish.touches()};
+  auto it = class_filters_.find(class_key);
+  if (it == std::end(class_filters_))
+  {
+    std::string name = wish.gesture() + std::to_string(wish.touches());
+    GeisFilter class_filter = geis_filter_new(geis_, name.c_str());
+    geis_filter_add_term(class_filter, GEIS_FILTER_CLASS,
+             GEIS_CLASS_ATTRIBUTE_NAME, GEIS_FILTER_OP_EQ, wish.gesture().c_str(),
+             GEIS_GESTURE_ATTRIBUTE_TOUCHES, GEIS_FILTER_OP_EQ, wish.touches(),
+             NULL);
+    it = class_filters_.emplace(class_key, class_filter).first;
+  }
+
+  std::string name = std::to_string(window_id) + "/" + wish.gesture()
+                   + std::to_string(wish.touches());
+  GeisFilter filter = geis_filter_clone(it->second, name.c_str());
+  if (window_id != GestureSource::root_window)
+  {
+    geis_filter_add_term(filter, GEIS_FILTER_REGION,
+             GEIS_REGION_ATTRIBUTE_WINDOWID, GEIS_FILTER_OP_EQ, window_id,
+             NULL);
+  }
+  return filter;
+}
+
+
 GeisGestureSource::Impl::
 ~Impl()
 {
+  for (auto const& shared_sub: subscriptions_)
+    geis_subscription_delete(shared_sub.second.geis_sub_);
+  for (auto geis_sub: idle_subscriptions_)
+    geis_subscription_delete(geis_sub);
+  for (auto const& class_filter: class_filters_)
+    geis_filter_delete(class_filter.second);
   g_io_channel_shutdown(iochannel_, FALSE, NULL);
   g_io_channel_unref(iochannel_);
   geis_delete(geis_);
@@ -225,22 +504,9 @@ set_event_callback(EventReceivedCallback const& event_callback)
 GestureSubscription::Ptr GeisGestureSource::
 subscribe(Window::Id window_id, Wish::Ptr const& wish)
 {
-  GeisSubscription geis_sub = geis_subscription_new(impl_->geis_,
-                                                    wish->name().c_str(),
-                                                    GEIS_SUBSCRIPTION_CONT);
-  std::string filter_name = wish->name();
-  GeisFilter filter = geis_filter_new(impl_->geis_, filter_name.c_str());
-  geis_filter_add_term(filter, GEIS_FILTER_REGION,
-           GEIS_REGION_ATTRIBUTE_WINDOWID, GEIS_FILTER_OP_EQ, window_id,
-           NULL);
-  geis_filter_add_term(filter, GEIS_FILTER_CLASS,
-           GEIS_CLASS_ATTRIBUTE_NAME, GEIS_FILTER_OP_EQ, wish->gesture().c_str(),
-           GEIS_GESTURE_ATTRIBUTE_TOUCHES, GEIS_FILTER_OP_EQ, wish->touches(),
-           NULL);
-  geis_subscription_add_filter(geis_sub, filter);
-  geis_subscription_activate(geis_sub);
-
-  return GestureSubscription::Ptr(new GeisGestureSubscription(geis_sub));
+  return GestureSubscription::Ptr(
+      new GeisGestureSubscription(impl_.get(),
+                                  impl_->acquire_subscription(window_id, *wish)));
 }
 
 
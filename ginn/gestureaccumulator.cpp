@@ -0,0 +1,101 @@
+/**
+ * @file ginn/gestureaccumulator.cpp
+ * @brief Definitions of the Ginn Gesture Accumulator module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/gestureaccumulator.h"
+
+
+namespace Ginn
+{
+
+const std::size_t GestureAccumulator::max_gestures;
+
+
+GestureAccumulator::
+GestureAccumulator()
+: next_serial_(1)
+{
+  for (std::size_t slot = 0; slot < gestures_.size(); ++slot)
+  {
+    gestures_[slot].gesture_id = 0;
+    gestures_[slot].serial = 0;
+    gestures_[slot].in_use = false;
+    gestures_[slot].slot = slot;
+  }
+}
+
+
+/**
+ * Finds the slot of a gesture in progress, or claims a new one for it.
+ *
+ * A new slot is a free one if there is any, otherwise the slot of the oldest
+ * gesture in progress.
+ */
+GestureAccumulator::Gesture& GestureAccumulator::
+find_or_claim(GestureEvent::GestureId gesture_id)
+{
+  Gesture* claim = nullptr;
+  for (auto& gesture: gestures_)
+  {
+    if (gesture.in_use)
+    {
+      if (gesture.gesture_id == gesture_id)
+        return gesture;
+      if (!claim || (claim->in_use && gesture.serial < claim->serial))
+        claim = &gesture;
+    }
+    else if (!claim || claim->in_use)
+    {
+      claim = &gesture;
+    }
+  }
+
+  claim->gesture_id = gesture_id;
+  claim->serial = next_serial_++;
+  claim->in_use = true;
+  claim->sums.fill(0.0f);
+  return *claim;
+}
+
+
+GestureAccumulator::Gesture const& GestureAccumulator::
+accumulate(GestureEvent::GestureId gesture_id,
+           PropertySnapshot const& properties)
+{
+  Gesture& gesture = find_or_claim(gesture_id);
+  for (Property::Id id = 0; id < Property::count(); ++id)
+  {
+    if (properties.has(id) && Property::is_delta(id))
+      gesture.sums[id] += properties.value(id);
+  }
+  return gesture;
+}
+
+
+void GestureAccumulator::
+release(GestureEvent::GestureId gesture_id)
+{
+  for (auto& gesture: gestures_)
+  {
+    if (gesture.in_use && gesture.gesture_id == gesture_id)
+      gesture.in_use = false;
+  }
+}
+
+} // namespace Ginn
@@ -0,0 +1,90 @@
+/**
+ * @file ginn/gestureaccumulator.h
+ * @brief Declarations of the Ginn Gesture Accumulator module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_GESTUREACCUMULATOR_H_
+#define GINN_GESTUREACCUMULATOR_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "ginn/gesturesource.h"
+#include "ginn/property.h"
+
+
+namespace Ginn
+{
+
+/**
+ * Running sums of the delta property values of gestures in progress.
+ *
+ * Delta properties like "delta x" are reported per frame, so a slow drag
+ * never has a big enough delta in any one frame to reach a threshold.  The
+ * accumulator keeps the sum of each delta property over all the frames of a
+ * gesture so far, so triggers can be evaluated against the total instead.
+ * Other properties, like positions, are absolute and are not summed.
+ *
+ * The accumulator is a flat table with a fixed number of slots keyed by
+ * gesture ID, allocated up front.  A slot is claimed when the first frame of a
+ * gesture is seen and freed again when the gesture ends.  If there are ever
+ * more gestures in progress than slots, the oldest gesture is dropped.
+ */
+class GestureAccumulator
+{
+public:
+  /** The maximum number of gestures tracked at the same time. */
+  static const std::size_t max_gestures = 16;
+
+  /** The accumulated state of a single gesture. */
+  struct Gesture
+  {
+    GestureEvent::GestureId                gesture_id;  ///< GEIS gesture ID
+    std::uint32_t                          serial;      ///< unique across reuse
+    bool                                   in_use;      ///< slot is taken
+    std::size_t                            slot;        ///< index of the slot
+    std::array<float, Property::max_count> sums;        ///< summed values
+  };
+
+public:
+  GestureAccumulator();
+
+  /**
+   * Adds the delta property values of a gesture frame to the sums of its
+   * gesture.
+   * @returns the updated state of the gesture.
+   */
+  Gesture const&
+  accumulate(GestureEvent::GestureId gesture_id,
+             PropertySnapshot const& properties);
+
+  /** Forgets all about a gesture that has ended. */
+  void
+  release(GestureEvent::GestureId gesture_id);
+
+private:
+  Gesture&
+  find_or_claim(GestureEvent::GestureId gesture_id);
+
+  std::array<Gesture, max_gestures>  gestures_;
+  std::uint32_t                      next_serial_;
+};
+
+} // namespace Ginn
+
+#endif // GINN_GESTUREACCUMULATOR_H_
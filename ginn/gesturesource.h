@@ -21,10 +21,13 @@
 #ifndef GINN_GESTURESOURCE_H_
 #define GINN_GESTURESOURCE_H_
 
+#include <cstddef>
 #include <functional>
 #include "ginn/application.h"
+#include "ginn/property.h"
 #include "ginn/wish.h"
 #include <memory>
+#include <string>
 
 
 namespace Ginn
@@ -33,15 +36,45 @@ class Window;
 
 /**
  * An abstract class wrapping gesture events.
+ *
+ * A gesture event is made up of one or more frames, one for each window the
+ * gesture was delivered to.
  */
 class GestureEvent
 {
+public:
+  /** Identifies a single gesture over the course of its frames. */
+  using GestureId = int;
+
 public:
   virtual
   ~GestureEvent() = 0;
 
+  /** Gets the phase of the gesture the event reports. */
+  virtual GesturePhase
+  phase() const = 0;
+
+  /** Gets the number of frames in the event. */
+  virtual std::size_t
+  frame_count() const = 0;
+
+  /** Gets the ID of the window a frame was delivered to. */
+  virtual Window::Id
+  window_id(std::size_t frame) const = 0;
+
+  /** Indicates if a frame is of a given gesture class and touch count. */
   virtual bool
-  matches(Window const* window, Wish::Ptr const& wish) const = 0;
+  is_gesture(std::size_t        frame,
+             std::string const& gesture,
+             int                touches) const = 0;
+
+  /** Gets the ID of the gesture a frame belongs to. */
+  virtual GestureId
+  gesture_id(std::size_t frame) const = 0;
+
+  /** Gets the values of the (interned) gesture properties of a frame. */
+  virtual PropertySnapshot const&
+  properties(std::size_t frame) const = 0;
 };
 
 
@@ -81,8 +114,16 @@ public:
   virtual void
   set_event_callback(EventReceivedCallback const& event_callback) = 0;
 
+  /**
+   * Subscribes to the gesture of a wish on a window.
+   *
+   * Subscribing on the root_window delivers the gesture wherever it happens.
+   */
   virtual GestureSubscription::Ptr
   subscribe(Window::Id window_id, Wish::Ptr const& wish) = 0;
+
+  /** The window ID that stands for the root window. */
+  static const Window::Id root_window = 0;
 };
 
 } // namespace Ginn
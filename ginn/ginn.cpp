@@ -23,18 +23,28 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include "ginn/actionsink.h"
 #include "ginn/activewishes.h"
 #include "ginn/applicationsource.h"
 #include "ginn/configuration.h"
 #include "ginn/gesturesource.h"
+#include "ginn/initbarrier.h"
 #include "ginn/keymap.h"
+#include "ginn/loadedsource.h"
 #include "ginn/wish.h"
+#include "ginn/wishbundle.h"
+#include "ginn/wishindex.h"
 #include "ginn/wishsource.h"
+#include "ginn/wishwatcher.h"
 #include <glib.h>
 #include <glib-unix.h>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <thread>
 #include <utility>
 
 
@@ -78,8 +88,28 @@ struct Ginn::Impl
        GestureSource*        gesture_source,
        ActionSink*           action_sink);
 
+  ~Impl();
+
+  void
+  start_loading_wishes();
+
+  static gboolean
+  on_wishes_loaded(gpointer data);
+
+  void
+  wishes_loaded();
+
+  void
+  resolve_wishes();
+
   void
-  load_raw_wishes();
+  wish_files_changed();
+
+  void
+  reload_wishes();
+
+  void
+  use_loaded_sources(LoadedSourceList&& loaded_sources);
 
   void
   app_source_initialized();
@@ -90,9 +120,15 @@ struct Ginn::Impl
   void
   window_closed(Window const* window);
 
+  void
+  window_changed(Window const* window);
+
   void
   keymap_initialized();
 
+  void
+  keymap_changed(Keymap::KeysymList const& changed);
+
   void
   action_sink_initialized();
 
@@ -102,60 +138,68 @@ struct Ginn::Impl
   void
   gesture_event(GestureEvent const& event);
 
-  /** Indicates if all the asynch Ginn init has completed. */
-  bool
-  is_initialized() const
-  {
-    return keymap_is_initialized_
-        && app_source_is_initialized_
-        && gesture_source_is_initialized
-        && action_sink_is_initialized_;
-  }
+  void
+  component_initialized(std::string const& name);
+
+  void
+  ginn_initialized();
 
   void
   run()
   { g_main_loop_run(main_loop_.get()); }
 
-  static gboolean
-  on_ginn_initialized(gpointer data);
-
 private:
   Configuration          config_;
+  InitBarrier            init_barrier_;
   WishSource*            wish_source_;
-  Wish::Table            wish_table_;
-  bool                   app_source_is_initialized_;
+  WishIndex              wish_index_;
+  bool                   wishes_are_loaded_;
+  std::thread            wish_loader_;
+  LoadedSourceList       loaded_sources_;
+  LoadedSourceList       loader_results_;
+  WishWatcher            wish_watcher_;
+  bool                   reload_is_pending_;
   ApplicationSource*     app_source_;
   bool                   keymap_is_initialized_;
   Keymap*                keymap_;
-  bool                   gesture_source_is_initialized;
   GestureSource*         gesture_source_;
   ActiveWishes           active_wishes_;
-  bool                   action_sink_is_initialized_;
   ActionSink*            action_sink_;
   main_loop_t            main_loop_;
 };
 
 
 /**
- * GLib callback for polling Ginn initialization state from an idle callback.
- * @param[in] data A disguised pointer to the Ginn object.
- *
- * This callback function determines if the Ginn is completely ready for action,
- * and if it is, creates the initial watches and starts the action.
+ * Reacts to one of the asynchronously-initialized components becoming ready.
+ * @param[in] name  The name of the component.
+ */
+void Ginn::Impl::
+component_initialized(std::string const& name)
+{
+  std::chrono::milliseconds elapsed = init_barrier_.arrive(name);
+  if (config_.is_verbose_mode())
+    std::cout << name << " initialized after " << elapsed.count() << "ms\n";
+}
+
+
+/**
+ * Reacts to the Ginn being completely ready for action.
  *
- * @returns true if the Ginn object is fully initialzed (and the idle callback
- * should be removed, false otherwise (and the callback should be re-queued).
+ * This is called exactly once, by the init barrier, when the last of the
+ * components has reported in.  The initial windows are reported so their
+ * wishes can be granted, and the wish files start being watched for changes.
  */
-gboolean Ginn::Impl::
-on_ginn_initialized(gpointer data)
+void Ginn::Impl::
+ginn_initialized()
 {
-  Ginn::Impl* ginn = (Ginn::Impl*)data;
-  if (ginn->is_initialized())
-  {
-    ginn->app_source_->report_windows();
-    return false;
-  }
-  return true;
+  if (config_.is_verbose_mode())
+    std::cout << "ready for gestures after "
+              << init_barrier_.elapsed().count() << "ms\n"
+              << init_barrier_;
+  app_source_->report_windows();
+  wish_watcher_.watch(config_.wish_source_directories());
+  if (reload_is_pending_)
+    reload_wishes();
 }
 
 
@@ -170,15 +214,17 @@ Impl(Configuration const&  config,
      GestureSource*        gesture_source,
      ActionSink*           action_sink)
 : config_(config)
+, init_barrier_({"wishes", "keymap", "application source", "gesture source", "action sink"},
+                std::bind(&Ginn::Impl::ginn_initialized, this))
 , wish_source_(wish_source)
-, app_source_is_initialized_(false)
+, wishes_are_loaded_(false)
+, wish_watcher_(config_)
+, reload_is_pending_(false)
 , app_source_(app_source)
 , keymap_is_initialized_(false)
 , keymap_(keymap)
-, gesture_source_is_initialized(false)
 , gesture_source_(gesture_source)
 , active_wishes_(config_, gesture_source_)
-, action_sink_is_initialized_(false)
 , action_sink_(action_sink)
 , main_loop_(g_main_loop_new(NULL, FALSE), g_main_loop_unref)
 { 
@@ -191,37 +237,143 @@ Impl(Configuration const&  config,
   g_unix_signal_add(SIGTERM, quit_cb, main_loop_.get());
   g_unix_signal_add(SIGINT,  quit_cb, main_loop_.get());
 
-  g_idle_add(on_ginn_initialized, this);
-
   app_source_->set_initialized_callback(bind(&Ginn::Impl::app_source_initialized, this));
   app_source_->set_window_opened_callback(bind(&Impl::window_opened, this, _1));
   app_source_->set_window_closed_callback(bind(&Impl::window_closed, this, _1));
+  app_source_->set_window_changed_callback(bind(&Impl::window_changed, this, _1));
   action_sink_->set_initialized_callback(bind(&Impl::action_sink_initialized, this));
   keymap_->set_initialized_callback(bind(&Ginn::Impl::keymap_initialized, this));
+  keymap_->set_changed_callback(bind(&Ginn::Impl::keymap_changed, this, _1));
   gesture_source_->set_initialized_callback(bind(&Ginn::Impl::gesture_source_initialized, this));
   gesture_source_->set_event_callback(bind(&Ginn::Impl::gesture_event, this, _1));
+  wish_watcher_.set_changed_callback(bind(&Ginn::Impl::wish_files_changed, this));
+
+  start_loading_wishes();
+}
+
+
+Ginn::Impl::
+~Impl()
+{
+  if (wish_loader_.joinable())
+  {
+    wish_loader_.join();
+    g_idle_remove_by_data(this);
+  }
 }
 
 
 /**
- * Loads the wishes from all the configured sources.
+ * Starts loading the wishes from all the configured sources.
+ *
+ * Reading, validating, and parsing the wishes needs nothing but the
+ * configuration, so it is done on a separate thread while the other components
+ * are initializing.  The wishes of each source are handed back to the main
+ * loop along with a hash of the source contents.  An exception escaping the
+ * loader thread would terminate the program, so a failure is reported and
+ * leaves no wishes loaded rather than keeping the main loop waiting.
  */
 void Ginn::Impl::
-load_raw_wishes()
+start_loading_wishes()
 {
-  WishSource::RawSourceList raw_sources = WishSource::read_raw_sources(&config_);
-  wish_table_ = wish_source_->get_wishes(raw_sources, keymap_);
+  wish_loader_ = std::thread([this]()
+  {
+    try
+    {
+      WishSource::RawSourceList raw_sources = WishSource::read_raw_sources(&config_);
+      WishSource::SourceWishes source_wishes = wish_source_->get_source_wishes(raw_sources);
+      for (std::size_t i = 0; i < raw_sources.size(); ++i)
+      {
+        loader_results_.push_back({raw_sources[i].name,
+                                   fnv1a_hash(raw_sources[i].source.data(),
+                                              raw_sources[i].source.size()),
+                                   std::move(source_wishes[i])});
+      }
+    }
+    catch (std::exception const& ex)
+    {
+      std::cerr << "error loading wishes: " << ex.what() << "\n";
+      loader_results_.clear();
+    }
+    g_idle_add(on_wishes_loaded, this);
+  });
+}
+
+
+/**
+ * GLib callback for handing the loaded wishes back to the main loop.
+ */
+gboolean Ginn::Impl::
+on_wishes_loaded(gpointer data)
+{
+  static_cast<Ginn::Impl*>(data)->wishes_loaded();
+  return FALSE;
+}
+
+
+/**
+ * Takes over the wishes loaded on the loader thread.
+ *
+ * The wishes' actions can only be bound to keycodes once the keymap is ready
+ * too.
+ */
+void Ginn::Impl::
+wishes_loaded()
+{
+  wish_loader_.join();
+  use_loaded_sources(std::move(loader_results_));
+  wishes_are_loaded_ = true;
   if (config_.is_verbose_mode())
-    std::cout << wish_table_.size() << " raw wishes loaded\n";
+    std::cout << "wishes for " << wish_index_.size() << " applications loaded\n";
+  if (keymap_is_initialized_)
+    resolve_wishes();
+  component_initialized("wishes");
 }
 
 
+/**
+ * Makes the wishes of a set of loaded sources the current wishes.
+ * @param[in] loaded_sources  The loaded sources, in order.
+ */
 void Ginn::Impl::
-app_source_initialized()
+use_loaded_sources(LoadedSourceList&& loaded_sources)
+{
+  loaded_sources_ = std::move(loaded_sources);
+  WishSource::SourceWishes source_wishes;
+  source_wishes.reserve(loaded_sources_.size());
+  for (auto const& source: loaded_sources_)
+    source_wishes.push_back(source.wishes);
+  wish_index_ = WishIndex(WishSource::merge_wishes(source_wishes));
+}
+
+
+/**
+ * Binds the keys in all the loaded wishes' actions to keycodes.
+ *
+ * Wishes overridden by a later source are bound as well, since they come back
+ * into play if the later source is changed.
+ */
+void Ginn::Impl::
+resolve_wishes()
 {
-  app_source_is_initialized_ = true;
+  for (auto& source: loaded_sources_)
+  {
+    for (auto& app_wishes: source.wishes)
+    {
+      for (auto& wish: app_wishes.second)
+        wish.second->resolve_keycodes(*keymap_);
+    }
+  }
   if (config_.is_verbose_mode())
-    std::cout << "application source is initialized\n";
+    std::cout << "wish keycodes resolved after "
+              << init_barrier_.elapsed().count() << "ms\n";
+}
+
+
+void Ginn::Impl::
+app_source_initialized()
+{
+  component_initialized("application source");
 }
 
 
@@ -231,17 +383,22 @@ app_source_initialized()
  *
  * If the window's application is not known, the window is ignored and will
  * probably be added later when the new-application notification comes in.
+ *
+ * Windows opened before ginn is fully initialized are ignored too, since all
+ * the known windows get reported once it is.
  */
 void Ginn::Impl::
 window_opened(Window const* window)
 {
   assert(window != nullptr);
+  if (!init_barrier_.is_open())
+    return;
 
   if (config_.is_verbose_mode())
     std::cout << __FUNCTION__ << ": adding wish for"
               << " '" << window->application_->name() << "'"
               << " window '" << window->title_ << "'\n";
-  active_wishes_.grant_wishes_for_window(wish_table_, window);
+  active_wishes_.grant_wishes_for_window(wish_index_, window);
 }
 
 
@@ -259,6 +416,18 @@ window_closed(Window const* window)
 }
 
 
+/**
+ * Reacts to an application window gaining or losing focus or visibility.
+ * @param[in]  window  The application window that changed.
+ */
+void Ginn::Impl::
+window_changed(Window const* window)
+{
+  assert(window != nullptr);
+  active_wishes_.update_window(window);
+}
+
+
 /**
  * Reacts to the Geis being initialized.
  *
@@ -268,9 +437,7 @@ window_closed(Window const* window)
 void Ginn::Impl::
 action_sink_initialized()
 {
-  action_sink_is_initialized_ = true;
-  if (config_.is_verbose_mode())
-    std::cout << "action sink is initialized\n";
+  component_initialized("action sink");
 }
 
 
@@ -278,17 +445,109 @@ action_sink_initialized()
  * Reacts to the keymap being initialized.
  *
  * The keymap can be initialized asynchronously, and it needs to be fully
- * initialized before the wishes get loaded because the wish loader needs the
- * keymap to map the keysyms found in a wish definition to the keycodes used in
- * the action sink.
+ * initialized before the keysyms found in the wish definitions can be mapped
+ * to the keycodes used in the action sink.
  */
 void Ginn::Impl::
 keymap_initialized()
 {
   keymap_is_initialized_ = true;
+  if (wishes_are_loaded_)
+    resolve_wishes();
+  component_initialized("keymap");
+}
+
+
+/**
+ * Reacts to the keymap changing.
+ * @param[in] changed  The keysyms whose keycodes have changed.
+ *
+ * The keycodes of the affected action events are updated in place in the
+ * loaded wishes, which are shared with the active wishes, so nothing needs to
+ * be reloaded or resubscribed.
+ */
+void Ginn::Impl::
+keymap_changed(Keymap::KeysymList const& changed)
+{
+  int changed_count = 0;
+  for (auto& source: loaded_sources_)
+  {
+    for (auto& app_wishes: source.wishes)
+    {
+      for (auto& wish: app_wishes.second)
+      {
+        if (wish.second->resolve_keycodes(*keymap_, changed))
+          ++changed_count;
+      }
+    }
+  }
   if (config_.is_verbose_mode())
-    std::cout << "keymap is initialized\n";
-  load_raw_wishes();
+    std::cout << "keymap changed, " << changed_count << " wishes updated\n";
+}
+
+
+/**
+ * Reacts to the wish files changing on disk.
+ *
+ * Changes that come in before ginn is fully initialized are picked up as soon
+ * as it is.
+ */
+void Ginn::Impl::
+wish_files_changed()
+{
+  if (!init_barrier_.is_open())
+  {
+    reload_is_pending_ = true;
+    return;
+  }
+  reload_wishes();
+}
+
+
+/**
+ * Reloads the wishes after the wish files have changed.
+ *
+ * Only sources that are new or whose contents have changed are parsed again;
+ * the wishes of the others are reused as they are.  The windows are then
+ * reported again so the active wishes can revoke and grant just the wishes
+ * that differ, leaving the subscriptions of unchanged wishes alone.
+ */
+void Ginn::Impl::
+reload_wishes()
+{
+  reload_is_pending_ = false;
+  wish_watcher_.watch(config_.wish_source_directories());
+
+  WishSource::RawSourceList raw_sources = WishSource::read_raw_sources(config_.scan_wish_sources());
+  SourceDiff diff = diff_sources(loaded_sources_, raw_sources);
+  if (diff.is_unchanged())
+    return;
+
+  WishSource::SourceWishes source_wishes;
+  try
+  {
+    source_wishes = wish_source_->get_source_wishes(diff.changed_sources);
+  }
+  catch (std::exception& ex)
+  {
+    std::cerr << "error reloading wishes, keeping the current ones: " << ex.what() << "\n";
+    return;
+  }
+  for (std::size_t i = 0; i < diff.changed_indexes.size(); ++i)
+  {
+    for (auto& app_wishes: source_wishes[i])
+    {
+      for (auto& wish: app_wishes.second)
+        wish.second->resolve_keycodes(*keymap_);
+    }
+    diff.sources[diff.changed_indexes[i]].wishes = std::move(source_wishes[i]);
+  }
+
+  if (config_.is_verbose_mode())
+    std::cout << "reloaded " << diff.changed_sources.size() << " of "
+              << diff.sources.size() << " wish files\n";
+  use_loaded_sources(std::move(diff.sources));
+  app_source_->report_windows();
 }
 
 
@@ -301,9 +560,7 @@ keymap_initialized()
 void Ginn::Impl::
 gesture_source_initialized()
 {
-  gesture_source_is_initialized = true;
-  if (config_.is_verbose_mode())
-    std::cout << "gesture recognizer is initialized\n";
+  component_initialized("gesture source");
 }
 
 
@@ -0,0 +1,83 @@
+/**
+ * @file ginn/initbarrier.cpp
+ * @brief Definitions of the Ginn Init Barrier module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/initbarrier.h"
+
+#include <algorithm>
+#include <iostream>
+
+
+namespace Ginn
+{
+
+InitBarrier::
+InitBarrier(std::vector<std::string> const& names, Callback const& on_ready)
+: start_time_(Clock::now())
+, pending_(names.size())
+, on_ready_(on_ready)
+{
+  components_.reserve(names.size());
+  for (auto const& name: names)
+    components_.push_back(Component{name, false, std::chrono::milliseconds(0)});
+}
+
+
+std::chrono::milliseconds InitBarrier::
+arrive(std::string const& name)
+{
+  std::chrono::milliseconds now = elapsed();
+  auto component = std::find_if(std::begin(components_), std::end(components_),
+                                [&name](Component const& c) -> bool
+                                { return c.name == name; });
+  if (component == std::end(components_) || component->arrived)
+    return now;
+
+  component->arrived = true;
+  component->elapsed = now;
+  --pending_;
+  if (pending_ == 0 && on_ready_)
+    on_ready_();
+  return now;
+}
+
+
+std::chrono::milliseconds InitBarrier::
+elapsed() const
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start_time_);
+}
+
+
+std::ostream&
+operator<<(std::ostream& ostr, InitBarrier const& barrier)
+{
+  for (auto const& component: barrier.components())
+  {
+    ostr << "  " << component.name << ": ";
+    if (component.arrived)
+      ostr << component.elapsed.count() << "ms\n";
+    else
+      ostr << "pending\n";
+  }
+  return ostr;
+}
+
+} // namespace Ginn
+
@@ -0,0 +1,115 @@
+/**
+ * @file ginn/initbarrier.h
+ * @brief Declarations of the Ginn Init Barrier module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_INITBARRIER_H_
+#define GINN_INITBARRIER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+
+namespace Ginn
+{
+
+/**
+ * A countdown of the components still to finish their asynchronous
+ * initialization.
+ *
+ * Each component arrives at the barrier once when it reports being ready.
+ * When the last one arrives the barrier opens and its ready callback is
+ * invoked, exactly once.  Nothing polls:  the barrier is driven entirely by the
+ * components' own initialized callbacks.
+ *
+ * The time each component took to arrive, measured from the construction of
+ * the barrier, is kept for reporting.
+ */
+class InitBarrier
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  using Callback = std::function<void()>;
+
+  /** A component the barrier is waiting for. */
+  struct Component
+  {
+    std::string               name;     ///< what is being waited for
+    bool                      arrived;  ///< the component is ready
+    std::chrono::milliseconds elapsed;  ///< time taken to become ready
+  };
+
+  using ComponentList = std::vector<Component>;
+
+public:
+  /**
+   * Creates a barrier waiting for the named components.
+   * @param[in] names     The components to wait for.
+   * @param[in] on_ready  Invoked when the last component arrives.
+   */
+  InitBarrier(std::vector<std::string> const& names, Callback const& on_ready);
+
+  /**
+   * Marks a component as ready.
+   * @param[in] name  The name of the component.
+   *
+   * A component arriving a second time, or one the barrier is not waiting for,
+   * is ignored.
+   *
+   * @returns the time since the barrier was created.
+   */
+  std::chrono::milliseconds
+  arrive(std::string const& name);
+
+  /** The number of components not yet ready. */
+  std::size_t
+  pending() const
+  { return pending_; }
+
+  /** Indicates if all the components are ready. */
+  bool
+  is_open() const
+  { return pending_ == 0; }
+
+  /** The time since the barrier was created. */
+  std::chrono::milliseconds
+  elapsed() const;
+
+  /** All the components and their init timings. */
+  ComponentList const&
+  components() const
+  { return components_; }
+
+private:
+  Clock::time_point start_time_;
+  ComponentList     components_;
+  std::size_t       pending_;
+  Callback          on_ready_;
+};
+
+/** Prints the init timings of all the components. */
+std::ostream&
+operator<<(std::ostream& ostr, InitBarrier const& barrier);
+
+} // namespace Ginn
+
+#endif // GINN_INITBARRIER_H_
@@ -20,13 +20,32 @@
  */
 #include "ginn/keymap.h"
 
+#include "ginn/keysym.h"
+#include <iostream>
+
 
 namespace Ginn
 {
 
+const Keymap::Keysym Keymap::no_symbol;
+
+
 Keymap::
 ~Keymap()
 { }
 
+
+Keymap::Keycode Keymap::
+to_keycode(std::string const& keysym_name) const
+{
+  Keysym keysym = keysym_from_name(keysym_name);
+  if (keysym == no_symbol)
+  {
+    std::cerr << "unrecognized keysym name '" << keysym_name << "'\n";
+    return 0;
+  }
+  return to_keycode(keysym);
+}
+
 } // namespace Ginn
 
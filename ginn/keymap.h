@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <functional>
 #include <string>
+#include <vector>
 
 
 namespace Ginn
@@ -35,9 +36,21 @@ public:
   /** The encoded key (may have to change for non-X11 support). */
   using Keycode = std::uint8_t;
 
+  /** The symbol engraved on a key (an X11 keysym). */
+  using Keysym = std::uint32_t;
+
+  /** The keysym that stands for no symbol at all. */
+  static const Keysym no_symbol = 0;
+
+  /** A sorted collection of keysyms. */
+  using KeysymList = std::vector<Keysym>;
+
   /** Signal for when Keymap has completed its asynchronous initialization. */
   using InitializedCallback = std::function<void()>;
 
+  /** Signal for when the keycodes of some keysyms have changed. */
+  using ChangedCallback = std::function<void(KeysymList const&)>;
+
 public:
   virtual
   ~Keymap() = 0;
@@ -45,8 +58,16 @@ public:
   virtual void
   set_initialized_callback(InitializedCallback const& initialized_callback) = 0;
 
+  virtual void
+  set_changed_callback(ChangedCallback const& changed_callback) = 0;
+
+  /** Gets the keycode that produces a keysym, or 0 if there is none. */
   virtual Keycode
-  to_keycode(std::string const& keysym_name) const = 0;
+  to_keycode(Keysym keysym) const = 0;
+
+  /** Gets the keycode that produces a named keysym, or 0 if there is none. */
+  Keycode
+  to_keycode(std::string const& keysym_name) const;
 };
 
 } // namespace Ginn
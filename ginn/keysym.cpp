@@ -0,0 +1,632 @@
+/**
+ * @file ginn/keysym.cpp
+ * @brief Definitions of the Ginn Keysym module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/keysym.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+
+namespace Ginn
+{
+
+namespace
+{
+
+struct KeysymName
+{
+  char const*     name;
+  Keymap::Keysym  keysym;
+};
+
+/**
+ * The known keysym names, sorted by name.
+ *
+ * Taken from the XK_MISCELLANY and XK_LATIN1 sections of X11/keysymdef.h and
+ * the vendor keysyms of X11/XF86keysym.h.
+ */
+const KeysymName keysym_names[] = {
+  { "0",                         0x00000030 },
+  { "1",                         0x00000031 },
+  { "2",                         0x00000032 },
+  { "3",                         0x00000033 },
+  { "4",                         0x00000034 },
+  { "5",                         0x00000035 },
+  { "6",                         0x00000036 },
+  { "7",                         0x00000037 },
+  { "8",                         0x00000038 },
+  { "9",                         0x00000039 },
+  { "A",                         0x00000041 },
+  { "AE",                        0x000000c6 },
+  { "Aacute",                    0x000000c1 },
+  { "Acircumflex",               0x000000c2 },
+  { "Adiaeresis",                0x000000c4 },
+  { "Agrave",                    0x000000c0 },
+  { "Alt_L",                     0x0000ffe9 },
+  { "Alt_R",                     0x0000ffea },
+  { "Aring",                     0x000000c5 },
+  { "Atilde",                    0x000000c3 },
+  { "B",                         0x00000042 },
+  { "BackSpace",                 0x0000ff08 },
+  { "Begin",                     0x0000ff58 },
+  { "Break",                     0x0000ff6b },
+  { "C",                         0x00000043 },
+  { "Cancel",                    0x0000ff69 },
+  { "Caps_Lock",                 0x0000ffe5 },
+  { "Ccedilla",                  0x000000c7 },
+  { "Clear",                     0x0000ff0b },
+  { "Codeinput",                 0x0000ff37 },
+  { "Control_L",                 0x0000ffe3 },
+  { "Control_R",                 0x0000ffe4 },
+  { "D",                         0x00000044 },
+  { "Delete",                    0x0000ffff },
+  { "Down",                      0x0000ff54 },
+  { "E",                         0x00000045 },
+  { "ETH",                       0x000000d0 },
+  { "Eacute",                    0x000000c9 },
+  { "Ecircumflex",               0x000000ca },
+  { "Ediaeresis",                0x000000cb },
+  { "Egrave",                    0x000000c8 },
+  { "Eisu_Shift",                0x0000ff2f },
+  { "Eisu_toggle",               0x0000ff30 },
+  { "End",                       0x0000ff57 },
+  { "Escape",                    0x0000ff1b },
+  { "Eth",                       0x000000d0 },
+  { "Execute",                   0x0000ff62 },
+  { "F",                         0x00000046 },
+  { "F1",                        0x0000ffbe },
+  { "F10",                       0x0000ffc7 },
+  { "F11",                       0x0000ffc8 },
+  { "F12",                       0x0000ffc9 },
+  { "F13",                       0x0000ffca },
+  { "F14",                       0x0000ffcb },
+  { "F15",                       0x0000ffcc },
+  { "F16",                       0x0000ffcd },
+  { "F17",                       0x0000ffce },
+  { "F18",                       0x0000ffcf },
+  { "F19",                       0x0000ffd0 },
+  { "F2",                        0x0000ffbf },
+  { "F20",                       0x0000ffd1 },
+  { "F21",                       0x0000ffd2 },
+  { "F22",                       0x0000ffd3 },
+  { "F23",                       0x0000ffd4 },
+  { "F24",                       0x0000ffd5 },
+  { "F25",                       0x0000ffd6 },
+  { "F26",                       0x0000ffd7 },
+  { "F27",                       0x0000ffd8 },
+  { "F28",                       0x0000ffd9 },
+  { "F29",                       0x0000ffda },
+  { "F3",                        0x0000ffc0 },
+  { "F30",                       0x0000ffdb },
+  { "F31",                       0x0000ffdc },
+  { "F32",                       0x0000ffdd },
+  { "F33",                       0x0000ffde },
+  { "F34",                       0x0000ffdf },
+  { "F35",                       0x0000ffe0 },
+  { "F4",                        0x0000ffc1 },
+  { "F5",                        0x0000ffc2 },
+  { "F6",                        0x0000ffc3 },
+  { "F7",                        0x0000ffc4 },
+  { "F8",                        0x0000ffc5 },
+  { "F9",                        0x0000ffc6 },
+  { "Find",                      0x0000ff68 },
+  { "G",                         0x00000047 },
+  { "H",                         0x00000048 },
+  { "Hankaku",                   0x0000ff29 },
+  { "Help",                      0x0000ff6a },
+  { "Henkan",                    0x0000ff23 },
+  { "Henkan_Mode",               0x0000ff23 },
+  { "Hiragana",                  0x0000ff25 },
+  { "Hiragana_Katakana",         0x0000ff27 },
+  { "Home",                      0x0000ff50 },
+  { "Hyper_L",                   0x0000ffed },
+  { "Hyper_R",                   0x0000ffee },
+  { "I",                         0x00000049 },
+  { "Iacute",                    0x000000cd },
+  { "Icircumflex",               0x000000ce },
+  { "Idiaeresis",                0x000000cf },
+  { "Igrave",                    0x000000cc },
+  { "Insert",                    0x0000ff63 },
+  { "J",                         0x0000004a },
+  { "K",                         0x0000004b },
+  { "KP_0",                      0x0000ffb0 },
+  { "KP_1",                      0x0000ffb1 },
+  { "KP_2",                      0x0000ffb2 },
+  { "KP_3",                      0x0000ffb3 },
+  { "KP_4",                      0x0000ffb4 },
+  { "KP_5",                      0x0000ffb5 },
+  { "KP_6",                      0x0000ffb6 },
+  { "KP_7",                      0x0000ffb7 },
+  { "KP_8",                      0x0000ffb8 },
+  { "KP_9",                      0x0000ffb9 },
+  { "KP_Add",                    0x0000ffab },
+  { "KP_Begin",                  0x0000ff9d },
+  { "KP_Decimal",                0x0000ffae },
+  { "KP_Delete",                 0x0000ff9f },
+  { "KP_Divide",                 0x0000ffaf },
+  { "KP_Down",                   0x0000ff99 },
+  { "KP_End",                    0x0000ff9c },
+  { "KP_Enter",                  0x0000ff8d },
+  { "KP_Equal",                  0x0000ffbd },
+  { "KP_F1",                     0x0000ff91 },
+  { "KP_F2",                     0x0000ff92 },
+  { "KP_F3",                     0x0000ff93 },
+  { "KP_F4",                     0x0000ff94 },
+  { "KP_Home",                   0x0000ff95 },
+  { "KP_Insert",                 0x0000ff9e },
+  { "KP_Left",                   0x0000ff96 },
+  { "KP_Multiply",               0x0000ffaa },
+  { "KP_Next",                   0x0000ff9b },
+  { "KP_Page_Down",              0x0000ff9b },
+  { "KP_Page_Up",                0x0000ff9a },
+  { "KP_Prior",                  0x0000ff9a },
+  { "KP_Right",                  0x0000ff98 },
+  { "KP_Separator",              0x0000ffac },
+  { "KP_Space",                  0x0000ff80 },
+  { "KP_Subtract",               0x0000ffad },
+  { "KP_Tab",                    0x0000ff89 },
+  { "KP_Up",                     0x0000ff97 },
+  { "Kana_Lock",                 0x0000ff2d },
+  { "Kana_Shift",                0x0000ff2e },
+  { "Kanji",                     0x0000ff21 },
+  { "Kanji_Bangou",              0x0000ff37 },
+  { "Katakana",                  0x0000ff26 },
+  { "L",                         0x0000004c },
+  { "L1",                        0x0000ffc8 },
+  { "L10",                       0x0000ffd1 },
+  { "L2",                        0x0000ffc9 },
+  { "L3",                        0x0000ffca },
+  { "L4",                        0x0000ffcb },
+  { "L5",                        0x0000ffcc },
+  { "L6",                        0x0000ffcd },
+  { "L7",                        0x0000ffce },
+  { "L8",                        0x0000ffcf },
+  { "L9",                        0x0000ffd0 },
+  { "Left",                      0x0000ff51 },
+  { "Linefeed",                  0x0000ff0a },
+  { "M",                         0x0000004d },
+  { "Mae_Koho",                  0x0000ff3e },
+  { "Massyo",                    0x0000ff2c },
+  { "Menu",                      0x0000ff67 },
+  { "Meta_L",                    0x0000ffe7 },
+  { "Meta_R",                    0x0000ffe8 },
+  { "Mode_switch",               0x0000ff7e },
+  { "Muhenkan",                  0x0000ff22 },
+  { "Multi_key",                 0x0000ff20 },
+  { "MultipleCandidate",         0x0000ff3d },
+  { "N",                         0x0000004e },
+  { "Next",                      0x0000ff56 },
+  { "Ntilde",                    0x000000d1 },
+  { "Num_Lock",                  0x0000ff7f },
+  { "O",                         0x0000004f },
+  { "Oacute",                    0x000000d3 },
+  { "Ocircumflex",               0x000000d4 },
+  { "Odiaeresis",                0x000000d6 },
+  { "Ograve",                    0x000000d2 },
+  { "Ooblique",                  0x000000d8 },
+  { "Oslash",                    0x000000d8 },
+  { "Otilde",                    0x000000d5 },
+  { "P",                         0x00000050 },
+  { "Page_Down",                 0x0000ff56 },
+  { "Page_Up",                   0x0000ff55 },
+  { "Pause",                     0x0000ff13 },
+  { "PreviousCandidate",         0x0000ff3e },
+  { "Print",                     0x0000ff61 },
+  { "Prior",                     0x0000ff55 },
+  { "Q",                         0x00000051 },
+  { "R",                         0x00000052 },
+  { "R1",                        0x0000ffd2 },
+  { "R10",                       0x0000ffdb },
+  { "R11",                       0x0000ffdc },
+  { "R12",                       0x0000ffdd },
+  { "R13",                       0x0000ffde },
+  { "R14",                       0x0000ffdf },
+  { "R15",                       0x0000ffe0 },
+  { "R2",                        0x0000ffd3 },
+  { "R3",                        0x0000ffd4 },
+  { "R4",                        0x0000ffd5 },
+  { "R5",                        0x0000ffd6 },
+  { "R6",                        0x0000ffd7 },
+  { "R7",                        0x0000ffd8 },
+  { "R8",                        0x0000ffd9 },
+  { "R9",                        0x0000ffda },
+  { "Redo",                      0x0000ff66 },
+  { "Return",                    0x0000ff0d },
+  { "Right",                     0x0000ff53 },
+  { "Romaji",                    0x0000ff24 },
+  { "S",                         0x00000053 },
+  { "Scroll_Lock",               0x0000ff14 },
+  { "Select",                    0x0000ff60 },
+  { "Shift_L",                   0x0000ffe1 },
+  { "Shift_Lock",                0x0000ffe6 },
+  { "Shift_R",                   0x0000ffe2 },
+  { "SingleCandidate",           0x0000ff3c },
+  { "Super_L",                   0x0000ffeb },
+  { "Super_R",                   0x0000ffec },
+  { "Sys_Req",                   0x0000ff15 },
+  { "T",                         0x00000054 },
+  { "THORN",                     0x000000de },
+  { "Tab",                       0x0000ff09 },
+  { "Thorn",                     0x000000de },
+  { "Touroku",                   0x0000ff2b },
+  { "U",                         0x00000055 },
+  { "Uacute",                    0x000000da },
+  { "Ucircumflex",               0x000000db },
+  { "Udiaeresis",                0x000000dc },
+  { "Ugrave",                    0x000000d9 },
+  { "Undo",                      0x0000ff65 },
+  { "Up",                        0x0000ff52 },
+  { "V",                         0x00000056 },
+  { "W",                         0x00000057 },
+  { "X",                         0x00000058 },
+  { "XF86AddFavorite",           0x1008ff39 },
+  { "XF86ApplicationLeft",       0x1008ff50 },
+  { "XF86ApplicationRight",      0x1008ff51 },
+  { "XF86AudioCycleTrack",       0x1008ff9b },
+  { "XF86AudioForward",          0x1008ff97 },
+  { "XF86AudioLowerVolume",      0x1008ff11 },
+  { "XF86AudioMedia",            0x1008ff32 },
+  { "XF86AudioMicMute",          0x1008ffb2 },
+  { "XF86AudioMute",             0x1008ff12 },
+  { "XF86AudioNext",             0x1008ff17 },
+  { "XF86AudioPause",            0x1008ff31 },
+  { "XF86AudioPlay",             0x1008ff14 },
+  { "XF86AudioPreset",           0x1008ffb6 },
+  { "XF86AudioPrev",             0x1008ff16 },
+  { "XF86AudioRaiseVolume",      0x1008ff13 },
+  { "XF86AudioRandomPlay",       0x1008ff99 },
+  { "XF86AudioRecord",           0x1008ff1c },
+  { "XF86AudioRepeat",           0x1008ff98 },
+  { "XF86AudioRewind",           0x1008ff3e },
+  { "XF86AudioStop",             0x1008ff15 },
+  { "XF86Away",                  0x1008ff8d },
+  { "XF86Back",                  0x1008ff26 },
+  { "XF86BackForward",           0x1008ff3f },
+  { "XF86Battery",               0x1008ff93 },
+  { "XF86Blue",                  0x1008ffa6 },
+  { "XF86Bluetooth",             0x1008ff94 },
+  { "XF86Book",                  0x1008ff52 },
+  { "XF86BrightnessAdjust",      0x1008ff3b },
+  { "XF86CD",                    0x1008ff53 },
+  { "XF86Calculater",            0x1008ff54 },
+  { "XF86Calculator",            0x1008ff1d },
+  { "XF86Calendar",              0x1008ff20 },
+  { "XF86Clear",                 0x1008ff55 },
+  { "XF86Close",                 0x1008ff56 },
+  { "XF86Community",             0x1008ff3d },
+  { "XF86ContrastAdjust",        0x1008ff22 },
+  { "XF86Copy",                  0x1008ff57 },
+  { "XF86Cut",                   0x1008ff58 },
+  { "XF86CycleAngle",            0x1008ff9c },
+  { "XF86DOS",                   0x1008ff5a },
+  { "XF86Display",               0x1008ff59 },
+  { "XF86Documents",             0x1008ff5b },
+  { "XF86Eject",                 0x1008ff2c },
+  { "XF86Excel",                 0x1008ff5c },
+  { "XF86Explorer",              0x1008ff5d },
+  { "XF86Favorites",             0x1008ff30 },
+  { "XF86Finance",               0x1008ff3c },
+  { "XF86Forward",               0x1008ff27 },
+  { "XF86FrameBack",             0x1008ff9d },
+  { "XF86FrameForward",          0x1008ff9e },
+  { "XF86FullScreen",            0x1008ffb8 },
+  { "XF86Game",                  0x1008ff5e },
+  { "XF86Go",                    0x1008ff5f },
+  { "XF86Green",                 0x1008ffa4 },
+  { "XF86Hibernate",             0x1008ffa8 },
+  { "XF86History",               0x1008ff37 },
+  { "XF86HomePage",              0x1008ff18 },
+  { "XF86HotLinks",              0x1008ff3a },
+  { "XF86KbdBrightnessDown",     0x1008ff06 },
+  { "XF86KbdBrightnessUp",       0x1008ff05 },
+  { "XF86KbdLightOnOff",         0x1008ff04 },
+  { "XF86Keyboard",              0x1008ffb3 },
+  { "XF86Launch0",               0x1008ff40 },
+  { "XF86Launch1",               0x1008ff41 },
+  { "XF86Launch2",               0x1008ff42 },
+  { "XF86Launch3",               0x1008ff43 },
+  { "XF86Launch4",               0x1008ff44 },
+  { "XF86Launch5",               0x1008ff45 },
+  { "XF86Launch6",               0x1008ff46 },
+  { "XF86Launch7",               0x1008ff47 },
+  { "XF86Launch8",               0x1008ff48 },
+  { "XF86Launch9",               0x1008ff49 },
+  { "XF86LaunchA",               0x1008ff4a },
+  { "XF86LaunchB",               0x1008ff4b },
+  { "XF86LaunchC",               0x1008ff4c },
+  { "XF86LaunchD",               0x1008ff4d },
+  { "XF86LaunchE",               0x1008ff4e },
+  { "XF86LaunchF",               0x1008ff4f },
+  { "XF86LightBulb",             0x1008ff35 },
+  { "XF86LogOff",                0x1008ff61 },
+  { "XF86Mail",                  0x1008ff19 },
+  { "XF86MailForward",           0x1008ff90 },
+  { "XF86Market",                0x1008ff62 },
+  { "XF86Meeting",               0x1008ff63 },
+  { "XF86Memo",                  0x1008ff1e },
+  { "XF86MenuKB",                0x1008ff65 },
+  { "XF86MenuPB",                0x1008ff66 },
+  { "XF86Messenger",             0x1008ff8e },
+  { "XF86ModeLock",              0x1008ff01 },
+  { "XF86MonBrightnessCycle",    0x1008ff07 },
+  { "XF86MonBrightnessDown",     0x1008ff03 },
+  { "XF86MonBrightnessUp",       0x1008ff02 },
+  { "XF86Music",                 0x1008ff92 },
+  { "XF86MyComputer",            0x1008ff33 },
+  { "XF86MySites",               0x1008ff67 },
+  { "XF86New",                   0x1008ff68 },
+  { "XF86News",                  0x1008ff69 },
+  { "XF86OfficeHome",            0x1008ff6a },
+  { "XF86Open",                  0x1008ff6b },
+  { "XF86OpenURL",               0x1008ff38 },
+  { "XF86Option",                0x1008ff6c },
+  { "XF86Paste",                 0x1008ff6d },
+  { "XF86Phone",                 0x1008ff6e },
+  { "XF86Pictures",              0x1008ff91 },
+  { "XF86PowerDown",             0x1008ff21 },
+  { "XF86PowerOff",              0x1008ff2a },
+  { "XF86Q",                     0x1008ff70 },
+  { "XF86RFKill",                0x1008ffb5 },
+  { "XF86Red",                   0x1008ffa3 },
+  { "XF86Refresh",               0x1008ff29 },
+  { "XF86Reload",                0x1008ff73 },
+  { "XF86Reply",                 0x1008ff72 },
+  { "XF86RockerDown",            0x1008ff24 },
+  { "XF86RockerEnter",           0x1008ff25 },
+  { "XF86RockerUp",              0x1008ff23 },
+  { "XF86RotateWindows",         0x1008ff74 },
+  { "XF86RotationKB",            0x1008ff76 },
+  { "XF86RotationLockToggle",    0x1008ffb7 },
+  { "XF86RotationPB",            0x1008ff75 },
+  { "XF86Save",                  0x1008ff77 },
+  { "XF86ScreenSaver",           0x1008ff2d },
+  { "XF86ScrollClick",           0x1008ff7a },
+  { "XF86ScrollDown",            0x1008ff79 },
+  { "XF86ScrollUp",              0x1008ff78 },
+  { "XF86Search",                0x1008ff1b },
+  { "XF86Select",                0x1008ffa0 },
+  { "XF86Send",                  0x1008ff7b },
+  { "XF86Shop",                  0x1008ff36 },
+  { "XF86Sleep",                 0x1008ff2f },
+  { "XF86Spell",                 0x1008ff7c },
+  { "XF86SplitScreen",           0x1008ff7d },
+  { "XF86Standby",               0x1008ff10 },
+  { "XF86Start",                 0x1008ff1a },
+  { "XF86Stop",                  0x1008ff28 },
+  { "XF86Subtitle",              0x1008ff9a },
+  { "XF86Support",               0x1008ff7e },
+  { "XF86Suspend",               0x1008ffa7 },
+  { "XF86TaskPane",              0x1008ff7f },
+  { "XF86Terminal",              0x1008ff80 },
+  { "XF86Time",                  0x1008ff9f },
+  { "XF86ToDoList",              0x1008ff1f },
+  { "XF86Tools",                 0x1008ff81 },
+  { "XF86TopMenu",               0x1008ffa2 },
+  { "XF86TouchpadOff",           0x1008ffb1 },
+  { "XF86TouchpadOn",            0x1008ffb0 },
+  { "XF86TouchpadToggle",        0x1008ffa9 },
+  { "XF86Travel",                0x1008ff82 },
+  { "XF86UWB",                   0x1008ff96 },
+  { "XF86User1KB",               0x1008ff85 },
+  { "XF86User2KB",               0x1008ff86 },
+  { "XF86UserPB",                0x1008ff84 },
+  { "XF86VendorHome",            0x1008ff34 },
+  { "XF86Video",                 0x1008ff87 },
+  { "XF86View",                  0x1008ffa1 },
+  { "XF86WLAN",                  0x1008ff95 },
+  { "XF86WWAN",                  0x1008ffb4 },
+  { "XF86WWW",                   0x1008ff2e },
+  { "XF86WakeUp",                0x1008ff2b },
+  { "XF86WebCam",                0x1008ff8f },
+  { "XF86WheelButton",           0x1008ff88 },
+  { "XF86Word",                  0x1008ff89 },
+  { "XF86Xfer",                  0x1008ff8a },
+  { "XF86Yellow",                0x1008ffa5 },
+  { "XF86ZoomIn",                0x1008ff8b },
+  { "XF86ZoomOut",               0x1008ff8c },
+  { "XF86iTouch",                0x1008ff60 },
+  { "Y",                         0x00000059 },
+  { "Yacute",                    0x000000dd },
+  { "Z",                         0x0000005a },
+  { "Zen_Koho",                  0x0000ff3d },
+  { "Zenkaku",                   0x0000ff28 },
+  { "Zenkaku_Hankaku",           0x0000ff2a },
+  { "a",                         0x00000061 },
+  { "aacute",                    0x000000e1 },
+  { "acircumflex",               0x000000e2 },
+  { "acute",                     0x000000b4 },
+  { "adiaeresis",                0x000000e4 },
+  { "ae",                        0x000000e6 },
+  { "agrave",                    0x000000e0 },
+  { "ampersand",                 0x00000026 },
+  { "apostrophe",                0x00000027 },
+  { "aring",                     0x000000e5 },
+  { "asciicircum",               0x0000005e },
+  { "asciitilde",                0x0000007e },
+  { "asterisk",                  0x0000002a },
+  { "at",                        0x00000040 },
+  { "atilde",                    0x000000e3 },
+  { "b",                         0x00000062 },
+  { "backslash",                 0x0000005c },
+  { "bar",                       0x0000007c },
+  { "braceleft",                 0x0000007b },
+  { "braceright",                0x0000007d },
+  { "bracketleft",               0x0000005b },
+  { "bracketright",              0x0000005d },
+  { "brokenbar",                 0x000000a6 },
+  { "c",                         0x00000063 },
+  { "ccedilla",                  0x000000e7 },
+  { "cedilla",                   0x000000b8 },
+  { "cent",                      0x000000a2 },
+  { "colon",                     0x0000003a },
+  { "comma",                     0x0000002c },
+  { "copyright",                 0x000000a9 },
+  { "currency",                  0x000000a4 },
+  { "d",                         0x00000064 },
+  { "degree",                    0x000000b0 },
+  { "diaeresis",                 0x000000a8 },
+  { "division",                  0x000000f7 },
+  { "dollar",                    0x00000024 },
+  { "e",                         0x00000065 },
+  { "eacute",                    0x000000e9 },
+  { "ecircumflex",               0x000000ea },
+  { "ediaeresis",                0x000000eb },
+  { "egrave",                    0x000000e8 },
+  { "equal",                     0x0000003d },
+  { "eth",                       0x000000f0 },
+  { "exclam",                    0x00000021 },
+  { "exclamdown",                0x000000a1 },
+  { "f",                         0x00000066 },
+  { "g",                         0x00000067 },
+  { "grave",                     0x00000060 },
+  { "greater",                   0x0000003e },
+  { "guillemotleft",             0x000000ab },
+  { "guillemotright",            0x000000bb },
+  { "h",                         0x00000068 },
+  { "hyphen",                    0x000000ad },
+  { "i",                         0x00000069 },
+  { "iacute",                    0x000000ed },
+  { "icircumflex",               0x000000ee },
+  { "idiaeresis",                0x000000ef },
+  { "igrave",                    0x000000ec },
+  { "j",                         0x0000006a },
+  { "k",                         0x0000006b },
+  { "l",                         0x0000006c },
+  { "less",                      0x0000003c },
+  { "m",                         0x0000006d },
+  { "macron",                    0x000000af },
+  { "masculine",                 0x000000ba },
+  { "minus",                     0x0000002d },
+  { "mu",                        0x000000b5 },
+  { "multiply",                  0x000000d7 },
+  { "n",                         0x0000006e },
+  { "nobreakspace",              0x000000a0 },
+  { "notsign",                   0x000000ac },
+  { "ntilde",                    0x000000f1 },
+  { "numbersign",                0x00000023 },
+  { "o",                         0x0000006f },
+  { "oacute",                    0x000000f3 },
+  { "ocircumflex",               0x000000f4 },
+  { "odiaeresis",                0x000000f6 },
+  { "ograve",                    0x000000f2 },
+  { "onehalf",                   0x000000bd },
+  { "onequarter",                0x000000bc },
+  { "onesuperior",               0x000000b9 },
+  { "ooblique",                  0x000000f8 },
+  { "ordfeminine",               0x000000aa },
+  { "oslash",                    0x000000f8 },
+  { "otilde",                    0x000000f5 },
+  { "p",                         0x00000070 },
+  { "paragraph",                 0x000000b6 },
+  { "parenleft",                 0x00000028 },
+  { "parenright",                0x00000029 },
+  { "percent",                   0x00000025 },
+  { "period",                    0x0000002e },
+  { "periodcentered",            0x000000b7 },
+  { "plus",                      0x0000002b },
+  { "plusminus",                 0x000000b1 },
+  { "q",                         0x00000071 },
+  { "question",                  0x0000003f },
+  { "questiondown",              0x000000bf },
+  { "quotedbl",                  0x00000022 },
+  { "quoteleft",                 0x00000060 },
+  { "quoteright",                0x00000027 },
+  { "r",                         0x00000072 },
+  { "registered",                0x000000ae },
+  { "s",                         0x00000073 },
+  { "script_switch",             0x0000ff7e },
+  { "section",                   0x000000a7 },
+  { "semicolon",                 0x0000003b },
+  { "slash",                     0x0000002f },
+  { "space",                     0x00000020 },
+  { "ssharp",                    0x000000df },
+  { "sterling",                  0x000000a3 },
+  { "t",                         0x00000074 },
+  { "thorn",                     0x000000fe },
+  { "threequarters",             0x000000be },
+  { "threesuperior",             0x000000b3 },
+  { "twosuperior",               0x000000b2 },
+  { "u",                         0x00000075 },
+  { "uacute",                    0x000000fa },
+  { "ucircumflex",               0x000000fb },
+  { "udiaeresis",                0x000000fc },
+  { "ugrave",                    0x000000f9 },
+  { "underscore",                0x0000005f },
+  { "v",                         0x00000076 },
+  { "w",                         0x00000077 },
+  { "x",                         0x00000078 },
+  { "y",                         0x00000079 },
+  { "yacute",                    0x000000fd },
+  { "ydiaeresis",                0x000000ff },
+  { "yen",                       0x000000a5 },
+  { "z",                         0x0000007a },
+};
+
+} // anonymous namespace
+
+
+Keymap::Keysym
+keysym_from_name(std::string const& name)
+{
+  auto it = std::lower_bound(std::begin(keysym_names), std::end(keysym_names), name,
+                             [](KeysymName const& k, std::string const& n) -> bool
+                             { return std::strcmp(k.name, n.c_str()) < 0; });
+  if (it != std::end(keysym_names) && name == it->name)
+    return it->keysym;
+
+  char* end = nullptr;
+  if (name.size() > 1 && name[0] == 'U')
+  {
+    unsigned long code = std::strtoul(name.c_str() + 1, &end, 16);
+    if (*end == '\0' && code > 0 && code <= 0x10ffff)
+    {
+      if (code < 0x100 && (code >= 0xa0 || (code >= 0x20 && code < 0x7f)))
+        return static_cast<Keymap::Keysym>(code);
+      return static_cast<Keymap::Keysym>(0x01000000 | code);
+    }
+  }
+  if (name.size() > 2 && name[0] == '0' && (name[1] == 'x' || name[1] == 'X'))
+  {
+    unsigned long keysym = std::strtoul(name.c_str() + 2, &end, 16);
+    if (*end == '\0')
+      return static_cast<Keymap::Keysym>(keysym);
+  }
+  return Keymap::no_symbol;
+}
+
+
+std::string
+keysym_to_name(Keymap::Keysym keysym)
+{
+  auto it = std::find_if(std::begin(keysym_names), std::end(keysym_names),
+                         [keysym](KeysymName const& k) -> bool
+                         { return k.keysym == keysym; });
+  if (it != std::end(keysym_names))
+    return it->name;
+
+  char buf[16];
+  std::snprintf(buf, sizeof(buf), "0x%04x", static_cast<unsigned>(keysym));
+  return buf;
+}
+
+} // namespace Ginn
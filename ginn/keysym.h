@@ -0,0 +1,55 @@
+/**
+ * @file ginn/keysym.h
+ * @brief Declarations of the Ginn Keysym module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_KEYSYM_H_
+#define GINN_KEYSYM_H_
+
+#include "ginn/keymap.h"
+#include <string>
+
+
+namespace Ginn
+{
+
+/**
+ * Converts a keysym name to its keysym.
+ * @param[in] name  A keysym name as used in wish files ("Page_Up", "KP_Add",
+ *                  "XF86AudioMute", ...), a Unicode name ("U20AC"), or a hex
+ *                  keysym value ("0xff55").
+ *
+ * The names of the Latin-1, miscellany, and XFree86 vendor keysyms are built
+ * in so no X library lookup or external program is needed.
+ *
+ * @returns the keysym or Keymap::no_symbol if the name is not recognized.
+ */
+Keymap::Keysym
+keysym_from_name(std::string const& name);
+
+/**
+ * Converts a keysym to its name.
+ *
+ * @returns the built-in name of the keysym, or its hex value if it has none.
+ */
+std::string
+keysym_to_name(Keymap::Keysym keysym);
+
+} // namespace Ginn
+
+#endif // GINN_KEYSYM_H_
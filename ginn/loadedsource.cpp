@@ -0,0 +1,62 @@
+/**
+ * @file ginn/loadedsource.cpp
+ * @brief Definitions of the Ginn Loaded Source module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/loadedsource.h"
+
+#include <algorithm>
+#include "ginn/wishbundle.h"
+#include <iterator>
+
+
+namespace Ginn
+{
+
+SourceDiff
+diff_sources(LoadedSourceList const&          loaded,
+             WishSource::RawSourceList const& raw_sources)
+{
+  SourceDiff diff;
+  for (auto const& raw_source: raw_sources)
+  {
+    std::uint64_t hash = fnv1a_hash(raw_source.source.data(), raw_source.source.size());
+    auto cached = std::find_if(std::begin(loaded), std::end(loaded),
+                               [&raw_source, hash](LoadedSource const& s) -> bool
+                               { return s.name == raw_source.name && s.hash == hash; });
+    if (cached != std::end(loaded))
+    {
+      diff.sources.push_back(*cached);
+    }
+    else
+    {
+      diff.changed_indexes.push_back(diff.sources.size());
+      diff.changed_sources.push_back(raw_source);
+      diff.sources.push_back({raw_source.name, hash, Wish::Table()});
+    }
+  }
+
+  diff.same_sources = diff.sources.size() == loaded.size()
+                   && std::equal(std::begin(diff.sources), std::end(diff.sources),
+                                 std::begin(loaded),
+                                 [](LoadedSource const& l, LoadedSource const& r) -> bool
+                                 { return l.name == r.name; });
+  return diff;
+}
+
+} // namespace Ginn
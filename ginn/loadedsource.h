@@ -0,0 +1,88 @@
+/**
+ * @file ginn/loadedsource.h
+ * @brief Declarations of the Ginn Loaded Source module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_LOADEDSOURCE_H_
+#define GINN_LOADEDSOURCE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include "ginn/wish.h"
+#include "ginn/wishsource.h"
+#include <string>
+#include <vector>
+
+
+namespace Ginn
+{
+
+/**
+ * The wishes loaded from one raw source, kept so that only the sources that
+ * actually change need to be parsed again.
+ */
+struct LoadedSource
+{
+  std::string   name;    ///< name of the source
+  std::uint64_t hash;    ///< hash of the source contents
+  Wish::Table   wishes;  ///< the wishes loaded from the source
+};
+
+using LoadedSourceList = std::vector<LoadedSource>;
+
+
+/**
+ * The differences between the loaded sources and a fresh read of the raw
+ * sources.
+ */
+struct SourceDiff
+{
+  /**
+   * All the freshly read sources, in order.  The unchanged ones carry over
+   * their loaded wishes, the others have none yet.
+   */
+  LoadedSourceList          sources;
+  /** The raw sources that are new or have changed contents. */
+  WishSource::RawSourceList changed_sources;
+  /** The position in sources of each of the changed sources. */
+  std::vector<std::size_t>  changed_indexes;
+  /** Whether the sources have the same names in the same order as before. */
+  bool                      same_sources;
+
+  /** Indicates if there is nothing to reload at all. */
+  bool
+  is_unchanged() const
+  { return changed_sources.empty() && same_sources; }
+};
+
+
+/**
+ * Compares freshly read raw sources against the loaded ones.
+ * @param[in] loaded       The sources currently loaded.
+ * @param[in] raw_sources  The raw sources as they are now.
+ *
+ * A raw source is unchanged if a loaded source has the same name and the same
+ * hash of its contents.
+ */
+SourceDiff
+diff_sources(LoadedSourceList const&          loaded,
+             WishSource::RawSourceList const& raw_sources);
+
+} // namespace Ginn
+
+#endif // GINN_LOADEDSOURCE_H_
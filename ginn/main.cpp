@@ -21,9 +21,11 @@
 #include "config.h"
 
 #include "ginn/bamfapplicationsource.h"
+#include "ginn/bundledwishsource.h"
 #include "ginn/configuration.h"
 #include "ginn/geisgesturesource.h"
 #include "ginn/ginn.h"
+#include "ginn/threadedactionsink.h"
 #include "ginn/wishsource.h"
 #include "ginn/x11actionsink.h"
 #include "ginn/x11keymap.h"
@@ -41,6 +43,13 @@ main(int argc, char* argv[])
   try
   {
     Configuration config(argc, argv);
+    if (config.is_compile_mode())
+    {
+      if (config.is_verbose_mode())
+        cout << __FUNCTION__ << ": compiling wishes\n";
+      return BundledWishSource::compile(&config) ? 0 : 1;
+    }
+
     if (config.is_verbose_mode())
       cout << __FUNCTION__ << ": creating components\n";
 
@@ -48,7 +57,10 @@ main(int argc, char* argv[])
     BamfApplicationSource app_source(config);
     GeisGestureSource gesture_source(config);
     X11Keymap x11_keymap(config);
-    X11ActionSink action_sink(config);
+    X11ActionSink x11_action_sink(config);
+    ThreadedActionSink action_sink(config,
+                                   &x11_action_sink,
+                                   config.action_queue_policy());
 
     if (config.is_verbose_mode())
       cout << __FUNCTION__ << ": creating Ginn\n";
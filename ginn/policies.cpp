@@ -0,0 +1,60 @@
+/**
+ * @file ginn/policies.cpp
+ * @brief Definitions of the Ginn Policies module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/policies.h"
+
+#include <iostream>
+
+
+namespace Ginn
+{
+
+std::ostream&
+operator<<(std::ostream& ostr, ActionQueuePolicy policy)
+{
+  switch (policy)
+  {
+    case ActionQueuePolicy::drop_oldest:
+      return ostr << "drop-oldest";
+    case ActionQueuePolicy::coalesce:
+      return ostr << "coalesce";
+    case ActionQueuePolicy::block:
+      return ostr << "block";
+  }
+  return ostr;
+}
+
+
+std::ostream&
+operator<<(std::ostream& ostr, SubscriptionPolicy policy)
+{
+  switch (policy)
+  {
+    case SubscriptionPolicy::eager:
+      return ostr << "eager";
+    case SubscriptionPolicy::lazy:
+      return ostr << "lazy";
+    case SubscriptionPolicy::root:
+      return ostr << "root";
+  }
+  return ostr;
+}
+
+} // namespace Ginn
@@ -0,0 +1,61 @@
+/**
+ * @file ginn/policies.h
+ * @brief Declarations of the Ginn Policies module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_POLICIES_H_
+#define GINN_POLICIES_H_
+
+#include <iosfwd>
+
+
+namespace Ginn
+{
+
+/**
+ * What to do with an action performed while the injection queue is full.
+ */
+enum class ActionQueuePolicy
+{
+  drop_oldest,  ///< discard the oldest queued action to make room
+  coalesce,     ///< discard the new action if it repeats the last one queued,
+                ///< otherwise discard the oldest queued action
+  block,        ///< wait for the injection thread to make room
+};
+
+std::ostream&
+operator<<(std::ostream& ostr, ActionQueuePolicy policy);
+
+
+/**
+ * When the gesture subscriptions of granted wishes are made.
+ */
+enum class SubscriptionPolicy
+{
+  eager,  ///< subscribe as soon as a wish is granted
+  lazy,   ///< subscribe only while the window is on screen or has the focus
+  root,   ///< subscribe once on the root window and dispatch to the wishes
+          ///< of the application with the focus
+};
+
+std::ostream&
+operator<<(std::ostream& ostr, SubscriptionPolicy policy);
+
+} // namespace Ginn
+
+#endif // GINN_POLICIES_H_
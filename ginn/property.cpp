@@ -0,0 +1,112 @@
+/**
+ * @file ginn/property.cpp
+ * @brief Definitions of the Ginn gesture Property module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/property.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+
+
+namespace Ginn
+{
+
+namespace
+{
+  using PropertyNames = std::array<std::string, Property::max_count>;
+
+  PropertyNames              property_names;
+  std::atomic<std::size_t>   property_count(0);
+  std::atomic<std::uint32_t> delta_properties(0);
+  std::mutex                 property_mutex;
+} // anonymous namespace
+
+
+const std::size_t Property::max_count;
+const Property::Id Property::invalid_id;
+
+
+/**
+ * Interns a property name.
+ * @param[in] name  The name of a gesture property.
+ *
+ * Wishes may be loaded on another thread, so interning is serialized.  Names
+ * are never removed and a name is stored and marked as a delta or not before
+ * the count is bumped, so reading the table up to count() needs no lock.
+ *
+ * @returns the ID of the property, or Property::invalid_id if the table of
+ * property names is full.
+ */
+Property::Id Property::
+intern(std::string const& name)
+{
+  std::lock_guard<std::mutex> lock(property_mutex);
+  auto end = std::begin(property_names) + property_count;
+  auto it = std::find(std::begin(property_names), end, name);
+  if (it != end)
+    return static_cast<Id>(it - std::begin(property_names));
+
+  if (property_count == max_count)
+  {
+    std::cerr << "too many distinct trigger properties, ignoring '"
+              << name << "'\n";
+    return invalid_id;
+  }
+
+  std::size_t id = property_count.load();
+  property_names[id] = name;
+  if (name.find("delta") != std::string::npos)
+    delta_properties |= (1u << id);
+  property_count.store(id + 1);
+  return static_cast<Id>(id);
+}
+
+
+Property::Id Property::
+find(std::string const& name)
+{
+  auto end = std::begin(property_names) + property_count;
+  auto it = std::find(std::begin(property_names), end, name);
+  return (it != end) ? static_cast<Id>(it - std::begin(property_names)) : invalid_id;
+}
+
+
+std::size_t Property::
+count()
+{
+  return property_count;
+}
+
+
+std::string const& Property::
+name(Id id)
+{
+  return property_names.at(id);
+}
+
+bool Property::
+is_delta(Id id)
+{
+  return id < max_count && (delta_properties & (1u << id));
+}
+
+} // namespace Ginn
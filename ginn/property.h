@@ -0,0 +1,121 @@
+/**
+ * @file ginn/property.h
+ * @brief Declarations of the Ginn gesture Property module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_PROPERTY_H_
+#define GINN_PROPERTY_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+namespace Ginn
+{
+
+/**
+ * The names of gesture properties ("delta x", "radius delta", ...) used as
+ * wish triggers.
+ *
+ * Property names are interned into small integer IDs as wishes are loaded, so
+ * a gesture event only needs to look up each property in use once per frame
+ * and evaluating a trigger is just an array index.
+ *
+ * Properties with "delta" in their name ("delta x", "angle delta", ...) are
+ * reported as the change since the previous frame, and are the only ones that
+ * make sense to sum over a gesture.  They are marked as such when interned.
+ */
+class Property
+{
+public:
+  /** A small integer identifying an interned property name. */
+  using Id = std::uint8_t;
+
+  /** The maximum number of distinct property names that can be interned. */
+  static const std::size_t max_count = 32;
+
+  /** The ID returned for a property name that could not be interned. */
+  static const Id invalid_id = 0xff;
+
+public:
+  /** Gets the ID of a property name, interning it if it's not yet known. */
+  static Id
+  intern(std::string const& name);
+
+  /**
+   * Gets the ID of a property name without interning it.
+   * @returns Property::invalid_id if the name has not been interned.
+   */
+  static Id
+  find(std::string const& name);
+
+  /** Gets the number of property names interned so far. */
+  static std::size_t
+  count();
+
+  /** Gets the name of an interned property. */
+  static std::string const&
+  name(Id id);
+
+  /** Indicates if an interned property is a per-frame delta. */
+  static bool
+  is_delta(Id id);
+};
+
+
+/**
+ * The values of the interned properties present in a single gesture frame.
+ *
+ * A snapshot has a fixed size and never allocates, so one can be filled in
+ * for every frame of every gesture event.
+ */
+class PropertySnapshot
+{
+public:
+  PropertySnapshot()
+  : present_(0)
+  { }
+
+  /** Sets the value of a property. */
+  void
+  set(Property::Id id, float value)
+  {
+    values_[id] = value;
+    present_ |= (1u << id);
+  }
+
+  /** Indicates if a property was present in the frame. */
+  bool
+  has(Property::Id id) const
+  { return id < Property::max_count && (present_ & (1u << id)); }
+
+  /** Gets the value of a property that was present in the frame. */
+  float
+  value(Property::Id id) const
+  { return values_[id]; }
+
+private:
+  std::array<float, Property::max_count> values_;
+  std::uint32_t                          present_;
+};
+
+} // namespace Ginn
+
+#endif // GINN_PROPERTY_H_
@@ -0,0 +1,152 @@
+/**
+ * @file ginn/slotmap.h
+ * @brief Declarations of the Ginn SlotMap module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_SLOTMAP_H_
+#define GINN_SLOTMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace Ginn
+{
+
+/**
+ * A handle to a value stored in a SlotMap.
+ *
+ * A handle stays valid until its value is erased, after which it no longer
+ * refers to anything even if its slot gets reused.
+ */
+struct SlotHandle
+{
+  std::uint32_t index;
+  std::uint32_t generation;
+
+  /** Indicates if the handle could refer to a value at all. */
+  bool
+  is_null() const
+  { return index == null_index; }
+
+  static const std::uint32_t null_index = UINT32_MAX;
+};
+
+/** A handle that refers to no value. */
+static const SlotHandle null_slot_handle = { SlotHandle::null_index, 0 };
+
+inline bool
+operator==(SlotHandle const& lhs, SlotHandle const& rhs)
+{ return lhs.index == rhs.index && lhs.generation == rhs.generation; }
+
+inline bool
+operator!=(SlotHandle const& lhs, SlotHandle const& rhs)
+{ return !(lhs == rhs); }
+
+
+/**
+ * A container of values addressed by generational handles.
+ *
+ * Inserting and erasing values take constant time and never move the other
+ * values, and erased slots are reused.  Each slot has a generation that is
+ * bumped when its value is erased, so stale handles are detected instead of
+ * silently referring to whatever took over the slot.
+ */
+template<typename T>
+class SlotMap
+{
+public:
+  SlotMap()
+  : size_(0)
+  { }
+
+  /** Stores a value and returns a handle to it. */
+  SlotHandle
+  insert(T value)
+  {
+    std::uint32_t index;
+    if (free_.empty())
+    {
+      index = static_cast<std::uint32_t>(slots_.size());
+      slots_.push_back(Slot{std::move(value), 0, true});
+    }
+    else
+    {
+      index = free_.back();
+      free_.pop_back();
+      slots_[index].value = std::move(value);
+      slots_[index].live = true;
+    }
+    ++size_;
+    return SlotHandle{index, slots_[index].generation};
+  }
+
+  /**
+   * Erases the value a handle refers to.
+   * @returns true if the handle referred to a value, false otherwise.
+   */
+  bool
+  erase(SlotHandle handle)
+  {
+    if (!get(handle))
+      return false;
+
+    Slot& slot = slots_[handle.index];
+    slot.value = T();
+    slot.live = false;
+    ++slot.generation;
+    free_.push_back(handle.index);
+    --size_;
+    return true;
+  }
+
+  /** Gets the value a handle refers to, or nullptr if it is stale. */
+  T*
+  get(SlotHandle handle)
+  {
+    if (handle.index >= slots_.size())
+      return nullptr;
+    Slot& slot = slots_[handle.index];
+    if (!slot.live || slot.generation != handle.generation)
+      return nullptr;
+    return &slot.value;
+  }
+
+  /** Gets the number of values stored. */
+  std::size_t
+  size() const
+  { return size_; }
+
+private:
+  struct Slot
+  {
+    T              value;
+    std::uint32_t  generation;
+    bool           live;
+  };
+
+  std::vector<Slot>          slots_;
+  std::vector<std::uint32_t> free_;
+  std::size_t                size_;
+};
+
+} // namespace Ginn
+
+#endif // GINN_SLOTMAP_H_
@@ -0,0 +1,91 @@
+/**
+ * @file ginn/sourcebuffer.cpp
+ * @brief Definitions of the Ginn Source Buffer class.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/sourcebuffer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+
+namespace Ginn
+{
+
+SourceBuffer::
+SourceBuffer()
+: data_("")
+, size_(0)
+{ }
+
+
+SourceBuffer::
+SourceBuffer(char const* str)
+: SourceBuffer(std::string(str))
+{ }
+
+
+SourceBuffer::
+SourceBuffer(std::string str)
+{
+  auto owner = std::make_shared<std::string>(std::move(str));
+  data_ = owner->data();
+  size_ = owner->size();
+  owner_ = std::move(owner);
+}
+
+
+bool SourceBuffer::
+map_file(std::string const& file_name, SourceBuffer& buffer)
+{
+  int fd = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (0 != fstat(fd, &st) || !S_ISREG(st.st_mode))
+  {
+    close(fd);
+    return false;
+  }
+
+  if (st.st_size == 0)
+  {
+    close(fd);
+    buffer = SourceBuffer();
+    return true;
+  }
+
+  std::size_t size = static_cast<std::size_t>(st.st_size);
+  void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return false;
+
+  buffer.owner_ = std::shared_ptr<void const>(map, [size](void const* p)
+                                              { munmap(const_cast<void*>(p), size); });
+  buffer.data_ = static_cast<char const*>(map);
+  buffer.size_ = size;
+  return true;
+}
+
+} // namespace Ginn
+
@@ -0,0 +1,86 @@
+/**
+ * @file ginn/sourcebuffer.h
+ * @brief Declarations of the Ginn Source Buffer class.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_SOURCEBUFFER_H_
+#define GINN_SOURCEBUFFER_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+
+namespace Ginn
+{
+
+/**
+ * A read-only view of the bytes of a source file.
+ *
+ * The bytes are either a read-only memory mapping of the file or, for sources
+ * that do not come from a file, an in-memory string.  Copies of a buffer
+ * share the same bytes, and the mapping is released when the last copy goes
+ * away.
+ */
+class SourceBuffer
+{
+public:
+  /** Creates an empty buffer. */
+  SourceBuffer();
+
+  /** Creates a buffer holding a copy of a C string. */
+  SourceBuffer(char const* str);
+
+  /** Creates a buffer holding a string. */
+  SourceBuffer(std::string str);
+
+  /**
+   * Maps a file read-only into a buffer.
+   * @param[in]  file_name  Names the file to map.
+   * @param[out] buffer     The mapped file, left alone on failure.
+   *
+   * An empty file gives an empty buffer without mapping anything.
+   *
+   * @returns true if the file could be read, false otherwise.
+   */
+  static bool
+  map_file(std::string const& file_name, SourceBuffer& buffer);
+
+  /** Gets the first byte of the buffer. */
+  char const*
+  data() const
+  { return data_; }
+
+  /** Gets the number of bytes in the buffer. */
+  std::size_t
+  size() const
+  { return size_; }
+
+  bool
+  empty() const
+  { return size_ == 0; }
+
+private:
+  std::shared_ptr<void const> owner_;
+  char const*                 data_;
+  std::size_t                 size_;
+};
+
+} // namespace Ginn
+
+#endif // GINN_SOURCEBUFFER_H_
@@ -0,0 +1,340 @@
+/**
+ * @file ginn/threadedactionsink.cpp
+ * @brief Definitions of the Ginn ThreadedActionSink module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/threadedactionsink.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include "ginn/action.h"
+#include "ginn/configuration.h"
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+
+namespace Ginn
+{
+
+const std::size_t ThreadedActionSink::default_capacity;
+
+
+/**
+ * A bounded lock-free queue of actions.
+ *
+ * Each cell carries a sequence number that tells whether it is ready to be
+ * written or read at a given queue position, so a push and a pop never touch
+ * the same cell at the same time.  Cells may be popped from more than one
+ * thread, which lets the performing thread drop the oldest action when the
+ * queue is full.
+ */
+class ActionRing
+{
+public:
+  ActionRing(std::size_t capacity)
+  : cells_(new Cell[capacity])
+  , mask_(capacity - 1)
+  , push_pos_(0)
+  , pop_pos_(0)
+  {
+    assert(capacity >= 2 && (capacity & mask_) == 0);
+    for (std::size_t i = 0; i < capacity; ++i)
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  bool
+  try_push(Action const& action)
+  {
+    std::size_t pos = push_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true)
+    {
+      cell = &cells_[pos & mask_];
+      std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+      std::ptrdiff_t dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (dif == 0)
+      {
+        if (push_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if (dif < 0)
+        return false;
+      else
+        pos = push_pos_.load(std::memory_order_relaxed);
+    }
+    cell->action = action;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool
+  try_pop(Action& action)
+  {
+    std::size_t pos = pop_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true)
+    {
+      cell = &cells_[pos & mask_];
+      std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+      std::ptrdiff_t dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+      if (dif == 0)
+      {
+        if (pop_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if (dif < 0)
+        return false;
+      else
+        pos = pop_pos_.load(std::memory_order_relaxed);
+    }
+    action = std::move(cell->action);
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool
+  is_empty() const
+  {
+    std::size_t pos = pop_pos_.load(std::memory_order_relaxed);
+    return cells_[pos & mask_].sequence.load(std::memory_order_acquire) != pos + 1;
+  }
+
+private:
+  struct Cell
+  {
+    std::atomic<std::size_t> sequence;
+    Action                   action;
+  };
+
+  std::unique_ptr<Cell[]>  cells_;
+  std::size_t              mask_;
+  std::atomic<std::size_t> push_pos_;
+  std::atomic<std::size_t> pop_pos_;
+};
+
+
+struct ThreadedActionSink::Impl
+{
+  Impl(Configuration const& config,
+       ActionSink*          sink,
+       ActionQueuePolicy    policy,
+       std::size_t          capacity);
+
+  void
+  make_room(Action const& action);
+
+  void
+  wake_injector();
+
+  void
+  run_injector();
+
+  Configuration            config_;
+  ActionSink*              sink_;
+  ActionQueuePolicy        policy_;
+  ActionRing               ring_;
+  Action                   last_pushed_;
+  std::atomic<std::size_t> dropped_count_;
+  std::atomic<bool>        sleeping_;
+  std::mutex               mutex_;
+  std::condition_variable  wakeup_;
+  std::condition_variable  room_;
+  bool                     wake_pending_;
+  bool                     stopping_;
+  std::thread              injector_;
+};
+
+
+ThreadedActionSink::Impl::
+Impl(Configuration const& config,
+     ActionSink*          sink,
+     ActionQueuePolicy    policy,
+     std::size_t          capacity)
+: config_(config)
+, sink_(sink)
+, policy_(policy)
+, ring_(capacity)
+, dropped_count_(0)
+, sleeping_(false)
+, wake_pending_(false)
+, stopping_(false)
+{ }
+
+
+/**
+ * Makes room in the full queue for an action according to the overflow
+ * policy.
+ */
+void ThreadedActionSink::Impl::
+make_room(Action const& action)
+{
+  Action dropped;
+  switch (policy_)
+  {
+    case ActionQueuePolicy::coalesce:
+      if (action == last_pushed_)
+      {
+        ++dropped_count_;
+        return;
+      }
+      // fall through
+    case ActionQueuePolicy::drop_oldest:
+      while (!ring_.try_push(action))
+      {
+        if (ring_.try_pop(dropped))
+          ++dropped_count_;
+      }
+      break;
+
+    case ActionQueuePolicy::block:
+      while (!ring_.try_push(action))
+      {
+        wake_injector();
+        std::unique_lock<std::mutex> lock(mutex_);
+        room_.wait_for(lock, std::chrono::milliseconds(1));
+      }
+      break;
+  }
+  last_pushed_ = action;
+}
+
+
+/**
+ * Wakes the injection thread if it is waiting for actions.
+ *
+ * The fence pairs with the one in run_injector():  either the injector sees
+ * the newly queued actions before going to sleep or this sees it sleeping.
+ */
+void ThreadedActionSink::Impl::
+wake_injector()
+{
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load(std::memory_order_relaxed))
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wake_pending_ = true;
+    wakeup_.notify_one();
+  }
+}
+
+
+/**
+ * The injection thread:  performs queued actions on the wrapped sink until
+ * stopped, flushing it each time the queue has been drained.
+ */
+void ThreadedActionSink::Impl::
+run_injector()
+{
+  Action action;
+  while (true)
+  {
+    bool performed = false;
+    while (ring_.try_pop(action))
+    {
+      sink_->perform(action);
+      performed = true;
+    }
+    if (performed)
+    {
+      sink_->flush();
+      room_.notify_all();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring_.is_empty())
+    {
+      if (stopping_)
+        break;
+      wakeup_.wait(lock, [this]() { return wake_pending_ || stopping_; });
+    }
+    wake_pending_ = false;
+    sleeping_.store(false, std::memory_order_relaxed);
+  }
+}
+
+
+ThreadedActionSink::
+ThreadedActionSink(Configuration const& config,
+                   ActionSink*          sink,
+                   ActionQueuePolicy    policy,
+                   std::size_t          capacity)
+: impl_(new Impl(config, sink, policy, capacity))
+{
+  impl_->injector_ = std::thread(&Impl::run_injector, impl_.get());
+  if (impl_->config_.is_verbose_mode())
+    std::cout << __FUNCTION__ << " created with " << policy << " policy\n";
+}
+
+
+ThreadedActionSink::
+~ThreadedActionSink()
+{
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->stopping_ = true;
+    impl_->wakeup_.notify_one();
+  }
+  impl_->injector_.join();
+  if (impl_->config_.is_verbose_mode())
+    std::cout << __FUNCTION__ << " dropped " << dropped_count() << " actions\n";
+}
+
+
+void ThreadedActionSink::
+set_initialized_callback(InitializedCallback const& callback)
+{
+  impl_->sink_->set_initialized_callback(callback);
+}
+
+
+/**
+ * Queues an action to be performed on the injection thread.
+ */
+void ThreadedActionSink::
+perform(Action const& action)
+{
+  if (impl_->ring_.try_push(action))
+    impl_->last_pushed_ = action;
+  else
+    impl_->make_room(action);
+}
+
+
+/**
+ * Wakes the injection thread to perform the queued actions.
+ */
+void ThreadedActionSink::
+flush()
+{
+  impl_->wake_injector();
+}
+
+
+std::size_t ThreadedActionSink::
+dropped_count() const
+{
+  return impl_->dropped_count_.load();
+}
+
+} // namespace Ginn
@@ -0,0 +1,90 @@
+/**
+ * @file ginn/threadedactionsink.h
+ * @brief Declarations of the Ginn ThreadedActionSink module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_THREADEDACTIONSINK_H_
+#define GINN_THREADEDACTIONSINK_H_
+
+#include "ginn/actionsink.h"
+#include <cstddef>
+#include "ginn/policies.h"
+#include <memory>
+
+
+namespace Ginn
+{
+class Configuration;
+
+
+/**
+ * An action sink that performs actions on another sink from a dedicated
+ * injection thread.
+ *
+ * Actions are handed over through a bounded lock-free ring buffer and the
+ * injection thread is woken on flush(), so performing an action never waits
+ * on the other sink (unless the overflow policy says to block).  The other
+ * sink is flushed from the injection thread each time it has drained the
+ * queue.
+ */
+class ThreadedActionSink
+: public ActionSink
+{
+public:
+  /** The default capacity of the injection queue. */
+  static const std::size_t default_capacity = 256;
+
+  /** Internal implementation of this class. */
+  struct Impl;
+
+public:
+  /**
+   * Creates a threaded action sink.
+   * @param[in] config    The Ginn configuration.
+   * @param[in] sink      The sink to perform actions on.
+   * @param[in] policy    What to do when the queue is full.
+   * @param[in] capacity  The size of the queue, a power of 2.
+   */
+  ThreadedActionSink(Configuration const& config,
+                     ActionSink*          sink,
+                     ActionQueuePolicy    policy,
+                     std::size_t          capacity = default_capacity);
+
+  /** Performs any queued actions and stops the injection thread. */
+  ~ThreadedActionSink();
+
+  void
+  set_initialized_callback(InitializedCallback const& callback);
+
+  void
+  perform(Action const& action);
+
+  void
+  flush();
+
+  /** Gets the number of actions discarded because the queue was full. */
+  std::size_t
+  dropped_count() const;
+
+private:
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace Ginn
+
+#endif // GINN_THREADEDACTIONSINK_H_
@@ -40,8 +40,8 @@ struct Window
   Id                  id_;
   std::string         title_;
   Application const*  application_;
-  bool                is_active_;
-  bool                is_visible_;
+  bool                is_active_;   ///< has the input focus
+  bool                is_visible_;  ///< not minimized and on the current workspace
   int                 monitor_;
 };
 
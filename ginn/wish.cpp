@@ -22,29 +22,115 @@
 
 #include "ginn/wishbuilder.h"
 #include <iostream>
+#include <string>
 #include <utility>
 
 
 namespace Ginn
 {
 
+/**
+ * Converts the value of an action's "when" attribute to a gesture phase.
+ * @param[in] when  One of "start", "update", or "finish".
+ *
+ * Anything unrecognized gets a warning and is treated as "update".
+ */
+static GesturePhase
+to_gesture_phase(std::string const& when)
+{
+  if (when == "start")
+    return GesturePhase::begin;
+  if (when == "finish")
+    return GesturePhase::end;
+  if (when != "update")
+    std::cerr << "unrecognized action phase '" << when << "', using 'update'\n";
+  return GesturePhase::update;
+}
+
+
+/**
+ * Converts the value of a trigger's "mode" attribute to a trigger mode.
+ * @param[in] mode      One of "instantaneous" or "accumulated", or empty.
+ * @param[in] property  The trigger property.
+ *
+ * Only delta properties are accumulated, so "accumulated" on any other
+ * property gets a warning, as does anything unrecognized, and is treated as
+ * "instantaneous".
+ */
+static Wish::TriggerMode
+to_trigger_mode(std::string const& mode, Property::Id property)
+{
+  if (mode == "accumulated")
+  {
+    if (Property::is_delta(property))
+      return Wish::TriggerMode::accumulated;
+    if (property != Property::invalid_id)
+      std::cerr << "trigger property '" << Property::name(property)
+                << "' is not a delta and can not be accumulated, using 'instantaneous'\n";
+  }
+  else if (!mode.empty() && mode != "instantaneous")
+    std::cerr << "unrecognized trigger mode '" << mode << "', using 'instantaneous'\n";
+  return Wish::TriggerMode::instantaneous;
+}
+
+
 Wish::
 Wish(const WishBuilder& builder)
 : name_(std::move(builder.name()))
 , gesture_(std::move(builder.gesture()))
 , touches_(std::move(builder.touches()))
-, when_(std::move(builder.when()))
+, when_(to_gesture_phase(builder.when()))
 , property_(std::move(builder.property()))
+, property_id_(Property::intern(property_))
 , min_(builder.min())
 , max_(builder.max())
+, trigger_mode_(to_trigger_mode(builder.trigger_mode(), property_id_))
+, min_interval_(builder.min_interval())
+, rearm_margin_(builder.rearm_margin())
+, max_fires_(builder.max_fires())
 , action_(std::move(builder.action()))
 {
 }
 
+bool
+operator==(Wish const& lhs, Wish const& rhs)
+{
+  return lhs.name() == rhs.name()
+      && lhs.gesture() == rhs.gesture()
+      && lhs.touches() == rhs.touches()
+      && lhs.when() == rhs.when()
+      && lhs.property_id() == rhs.property_id()
+      && lhs.min() == rhs.min()
+      && lhs.max() == rhs.max()
+      && lhs.trigger_mode() == rhs.trigger_mode()
+      && lhs.min_interval() == rhs.min_interval()
+      && lhs.rearm_margin() == rhs.rearm_margin()
+      && lhs.max_fires() == rhs.max_fires()
+      && lhs.action() == rhs.action();
+}
+
+
+std::ostream&
+operator<<(std::ostream& ostr, GesturePhase phase)
+{
+  switch (phase)
+  {
+    case GesturePhase::begin:
+      return ostr << "start";
+    case GesturePhase::update:
+      return ostr << "update";
+    case GesturePhase::end:
+      return ostr << "finish";
+  }
+  return ostr;
+}
+
+
 std::ostream&
 operator<<(std::ostream& ostr, Wish const& wish)
 {
-  ostr << wish.name() << " {" << wish.gesture() << wish.touches() << "}";
+  ostr << wish.name() << " {" << wish.gesture() << wish.touches()
+       << " " << wish.when() << "}";
   return ostr;
 }
 
@@ -22,6 +22,9 @@
 #define GINN_WISH_H_
 
 #include "ginn/action.h"
+#include <chrono>
+#include "ginn/property.h"
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <string>
@@ -31,6 +34,19 @@ namespace Ginn
 {
 class WishBuilder;
 
+/**
+ * The phases of a gesture at which a wish may be fulfilled.
+ */
+enum class GesturePhase
+{
+  begin,   ///< the gesture has just been recognized
+  update,  ///< the gesture is in progress
+  end,     ///< the gesture has finished
+};
+
+/** The number of distinct gesture phases. */
+static const std::size_t gesture_phase_count = 3;
+
 
 /**
  * A description of a mapping between a multi-touch gesture and an action.
@@ -41,13 +57,11 @@ class WishBuilder;
  * server.
  *
  * Wishes are grouped into collections and the collections associated with
- * applications.
+ * applications.  A WishIndex compiled from a Table matches applications to
+ * their wishes.
  *
  * @todo Refine the internals of this class to maybe hide stuff better.
  *
- * @todo Break the Table key into a separate class so apps can be matched by
- * name, generic_name, or desktop_name.
- *
  * @todo Redesign wishes to allow for more complex (continuation) gestures,
  * like tap-and-hold, with timeouts etc.
  */
@@ -61,6 +75,13 @@ public:
   /** A collection of wishes grouped by application name. */
   using Table = std::map<std::string, Wish::List>;
 
+  /** How the trigger property value is evaluated. */
+  enum class TriggerMode
+  {
+    instantaneous,  ///< the value in each frame is tested on its own
+    accumulated,    ///< the sum of the values over the gesture is tested
+  };
+
 public:
   Wish(const WishBuilder& builder);
 
@@ -77,10 +98,20 @@ public:
   touches() const
   { return touches_; }
 
+  /** Gets the gesture phase during which the wish may be fulfilled. */
+  GesturePhase
+  when() const
+  { return when_; }
+
   std::string const&
   property() const
   { return property_; }
 
+  /** Gets the interned ID of the trigger property. */
+  Property::Id
+  property_id() const
+  { return property_id_; }
+
   float
   min() const
   { return min_; }
@@ -89,21 +120,88 @@ public:
   max() const
   { return max_; }
 
+  TriggerMode
+  trigger_mode() const
+  { return trigger_mode_; }
+
+  /** Indicates if a trigger property value fulfils the wish. */
+  bool
+  is_triggered_by(float value) const
+  { return min_ <= value && value <= max_; }
+
+  /** Gets the minimum time between fulfilments during a single gesture. */
+  std::chrono::milliseconds
+  min_interval() const
+  { return min_interval_; }
+
+  /** Indicates if the wish must be re-armed after being fulfilled. */
+  bool
+  needs_rearm() const
+  { return rearm_margin_ >= 0.0f; }
+
+  /** Gets the re-arm margin, negative if the wish never needs re-arming. */
+  float
+  rearm_margin() const
+  { return rearm_margin_; }
+
+  /**
+   * Indicates if a trigger property value re-arms the wish.
+   *
+   * The value must leave the trigger range by at least the re-arm margin.
+   */
+  bool
+  is_rearmed_by(float value) const
+  { return value < min_ - rearm_margin_ || max_ + rearm_margin_ < value; }
+
+  /** Gets the maximum fulfilments during a single gesture, 0 for no limit. */
+  unsigned int
+  max_fires() const
+  { return max_fires_; }
+
   Action const&
   action() const
   { return action_; }
 
+  /**
+   * Looks up the keycodes of the wish's action again after a keymap change.
+   * @returns true if any keycode was changed.
+   */
+  bool
+  resolve_keycodes(Keymap const& keymap, Keymap::KeysymList const& changed)
+  { return action_.resolve(keymap, changed); }
+
+  /** Binds the keys of the wish's action to keycodes. */
+  void
+  resolve_keycodes(Keymap const& keymap)
+  { action_.resolve(keymap); }
+
 private:
-  std::string name_;
-  std::string gesture_;
-  int         touches_;
-  std::string when_;
-  std::string property_;
-  float       min_;
-  float       max_;
-  Action      action_;
+  std::string   name_;
+  std::string   gesture_;
+  int           touches_;
+  GesturePhase  when_;
+  std::string   property_;
+  Property::Id  property_id_;
+  float         min_;
+  float         max_;
+  TriggerMode   trigger_mode_;
+  std::chrono::milliseconds min_interval_;
+  float         rearm_margin_;
+  unsigned int  max_fires_;
+  Action        action_;
 };
 
+/** Indicates if two wishes describe the same gesture, trigger, and action. */
+bool
+operator==(Wish const& lhs, Wish const& rhs);
+
+inline bool
+operator!=(Wish const& lhs, Wish const& rhs)
+{ return !(lhs == rhs); }
+
+std::ostream&
+operator<<(std::ostream& ostr, GesturePhase phase);
+
 std::ostream&
 operator<<(std::ostream& ostr, Wish const& wish);
 
@@ -58,6 +58,21 @@ public:
   virtual float
   max() const = 0;
 
+  virtual std::string
+  trigger_mode() const = 0;
+
+  /** The minimum interval between fulfilments, in milliseconds. */
+  virtual int
+  min_interval() const = 0;
+
+  /** The re-arm margin, or a negative value if no re-arming is required. */
+  virtual float
+  rearm_margin() const = 0;
+
+  /** The maximum fulfilments per gesture, or 0 for no limit. */
+  virtual unsigned int
+  max_fires() const = 0;
+
   virtual Action
   action() const = 0;
 };
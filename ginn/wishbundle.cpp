@@ -0,0 +1,596 @@
+/**
+ * @file ginn/wishbundle.cpp
+ * @brief Definitions of the Ginn Wish Bundle module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/wishbundle.h"
+
+#include <cstdio>
+#include <cstring>
+#include "ginn/actionbuilder.h"
+#include "ginn/sourcebuffer.h"
+#include "ginn/wishbuilder.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+#include <unordered_map>
+#include <vector>
+
+
+namespace Ginn
+{
+
+namespace
+{
+
+/** Identifies a wish bundle file. */
+const char bundle_magic[8] = { 'G', 'I', 'N', 'N', 'W', 'B', 'N', 'D' };
+
+/** Bumped whenever the layout of the records changes. */
+const std::uint32_t bundle_version = 2;
+
+/**
+ * The bundle file header.
+ *
+ * The header is followed by the source records, the application records, the
+ * wish records, the event records, the string records, and finally the
+ * string bytes, each packed right after the other.
+ */
+struct BundleHeader
+{
+  char          magic[8];
+  std::uint32_t version;
+  std::uint32_t source_count;
+  std::uint32_t app_count;
+  std::uint32_t wish_count;
+  std::uint32_t event_count;
+  std::uint32_t string_count;
+  std::uint32_t string_bytes;
+  std::uint32_t reserved;
+};
+
+/** A raw source the bundle was compiled from. */
+struct SourceRecord
+{
+  std::uint32_t name;
+  std::uint32_t reserved;
+  std::uint64_t hash;
+};
+
+/**
+ * An application in one raw source and the range of its wishes in the wish
+ * records.  Applications are kept in raw source order.
+ */
+struct AppRecord
+{
+  std::uint32_t name;
+  std::uint32_t source;
+  std::uint32_t first_wish;
+  std::uint32_t wish_count;
+};
+
+/** A wish and the range of its action events in the event records. */
+struct WishRecord
+{
+  std::uint32_t name;
+  std::uint32_t gesture;
+  std::int32_t  touches;
+  std::uint32_t when;
+  std::uint32_t property;
+  float         min;
+  float         max;
+  std::uint32_t trigger_mode;
+  std::int32_t  min_interval;
+  float         rearm_margin;
+  std::uint32_t max_fires;
+  std::uint32_t first_event;
+  std::uint32_t event_count;
+};
+
+/** An action event. */
+struct EventRecord
+{
+  std::uint32_t type;
+  std::uint32_t code;
+  std::uint32_t keysym;
+};
+
+/** Locates an interned string in the string bytes. */
+struct StringRecord
+{
+  std::uint32_t offset;
+  std::uint32_t length;
+};
+
+
+/**
+ * Collects the distinct strings of a bundle as it is being compiled.
+ */
+class StringInterner
+{
+public:
+  std::uint32_t
+  intern(std::string const& str)
+  {
+    auto it = index_.find(str);
+    if (it != std::end(index_))
+      return it->second;
+
+    std::uint32_t id = static_cast<std::uint32_t>(records_.size());
+    records_.push_back(StringRecord{static_cast<std::uint32_t>(bytes_.size()),
+                                    static_cast<std::uint32_t>(str.size())});
+    bytes_ += str;
+    index_.emplace(str, id);
+    return id;
+  }
+
+  std::vector<StringRecord> const&
+  records() const
+  { return records_; }
+
+  std::string const&
+  bytes() const
+  { return bytes_; }
+
+private:
+  std::unordered_map<std::string, std::uint32_t> index_;
+  std::vector<StringRecord>                      records_;
+  std::string                                    bytes_;
+};
+
+
+/**
+ * The record arrays of a mapped bundle.
+ */
+struct BundleLayout
+{
+  std::string
+  string(std::uint32_t id) const
+  { return std::string(string_bytes + strings[id].offset, strings[id].length); }
+
+  BundleHeader const* header;
+  SourceRecord const* sources;
+  AppRecord const*    apps;
+  WishRecord const*   wishes;
+  EventRecord const*  events;
+  StringRecord const* strings;
+  char const*         string_bytes;
+};
+
+
+template<typename Record>
+void
+append_records(std::string& buffer, std::vector<Record> const& records)
+{
+  buffer.append(reinterpret_cast<char const*>(records.data()),
+                records.size() * sizeof(Record));
+}
+
+
+std::string
+to_string(Wish::TriggerMode mode)
+{
+  return mode == Wish::TriggerMode::accumulated ? "accumulated" : "instantaneous";
+}
+
+} // anonymous namespace
+
+
+std::uint64_t
+fnv1a_hash(char const* data, std::size_t size)
+{
+  std::uint64_t hash = 14695981039346656037ull;
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+
+bool WishBundle::
+write(std::string const&               file_name,
+      WishSource::RawSourceList const& raw_sources,
+      WishSource::SourceWishes const&  source_wishes)
+{
+  StringInterner            strings;
+  std::vector<SourceRecord> sources;
+  std::vector<AppRecord>    apps;
+  std::vector<WishRecord>   wishes;
+  std::vector<EventRecord>  events;
+
+  for (auto const& raw_source: raw_sources)
+  {
+    sources.push_back(SourceRecord{strings.intern(raw_source.name),
+                                   0,
+                                   fnv1a_hash(raw_source.source.data(),
+                                              raw_source.source.size())});
+  }
+
+  for (std::size_t source = 0; source < source_wishes.size() && source < raw_sources.size(); ++source)
+  {
+    for (auto const& app: source_wishes[source])
+    {
+      apps.push_back(AppRecord{strings.intern(app.first),
+                               static_cast<std::uint32_t>(source),
+                               static_cast<std::uint32_t>(wishes.size()),
+                               static_cast<std::uint32_t>(app.second.size())});
+      for (auto const& entry: app.second)
+      {
+        Wish const& wish = *entry.second;
+        std::ostringstream when;
+        when << wish.when();
+        std::uint32_t first_event = static_cast<std::uint32_t>(events.size());
+        for (auto const& event: wish.action())
+        {
+          events.push_back(EventRecord{static_cast<std::uint32_t>(event.type),
+                                       event.code,
+                                       event.keysym});
+        }
+        wishes.push_back(WishRecord{strings.intern(wish.name()),
+                                    strings.intern(wish.gesture()),
+                                    wish.touches(),
+                                    strings.intern(when.str()),
+                                    strings.intern(wish.property()),
+                                    wish.min(),
+                                    wish.max(),
+                                    strings.intern(to_string(wish.trigger_mode())),
+                                    static_cast<std::int32_t>(wish.min_interval().count()),
+                                    wish.rearm_margin(),
+                                    wish.max_fires(),
+                                    first_event,
+                                    static_cast<std::uint32_t>(events.size()) - first_event});
+      }
+    }
+  }
+
+
+  BundleHeader header;
+  std::memcpy(header.magic, bundle_magic, sizeof(header.magic));
+  header.version = bundle_version;
+  header.source_count = static_cast<std::uint32_t>(sources.size());
+  header.app_count = static_cast<std::uint32_t>(apps.size());
+  header.wish_count = static_cast<std::uint32_t>(wishes.size());
+  header.event_count = static_cast<std::uint32_t>(events.size());
+  header.string_count = static_cast<std::uint32_t>(strings.records().size());
+  header.string_bytes = static_cast<std::uint32_t>(strings.bytes().size());
+  header.reserved = 0;
+
+  std::string buffer(reinterpret_cast<char const*>(&header), sizeof(header));
+  append_records(buffer, sources);
+  append_records(buffer, apps);
+  append_records(buffer, wishes);
+  append_records(buffer, events);
+  append_records(buffer, strings.records());
+  buffer += strings.bytes();
+
+  std::string::size_type slash = file_name.rfind('/');
+  if (slash != std::string::npos && slash > 0)
+    mkdir(file_name.substr(0, slash).c_str(), 0700);
+
+  std::string temp_file_name = file_name + ".tmp";
+  {
+    std::ofstream ofs(temp_file_name, std::ios::binary | std::ios::trunc);
+    if (!ofs.write(buffer.data(), buffer.size()))
+    {
+      std::cerr << "error writing wish bundle '" << temp_file_name << "'\n";
+      return false;
+    }
+  }
+  if (0 != std::rename(temp_file_name.c_str(), file_name.c_str()))
+  {
+    std::cerr << "error renaming wish bundle to '" << file_name << "'\n";
+    std::remove(temp_file_name.c_str());
+    return false;
+  }
+  return true;
+}
+
+
+/**
+ * Copies a wish out of its bundle record.
+ */
+class BundleWishBuilder
+: public WishBuilder
+{
+public:
+  BundleWishBuilder(BundleLayout const& bundle, WishRecord const& record);
+
+  std::string
+  name() const;
+
+  std::string
+  gesture() const;
+
+  int
+  touches() const
+  { return record_.touches; }
+
+  std::string
+  when() const;
+
+  std::string
+  property() const;
+
+  float
+  min() const
+  { return record_.min; }
+
+  float
+  max() const
+  { return record_.max; }
+
+  std::string
+  trigger_mode() const;
+
+  int
+  min_interval() const
+  { return record_.min_interval; }
+
+  float
+  rearm_margin() const
+  { return record_.rearm_margin; }
+
+  unsigned int
+  max_fires() const
+  { return record_.max_fires; }
+
+  Action
+  action() const;
+
+private:
+  BundleLayout const& bundle_;
+  WishRecord const&   record_;
+};
+
+
+/**
+ * Copies the events of an action out of their bundle records.
+ */
+class BundleActionBuilder
+: public ActionBuilder
+{
+public:
+  BundleActionBuilder(EventRecord const* first, std::uint32_t count)
+  {
+    events_.reserve(count);
+    for (EventRecord const* e = first; e != first + count; ++e)
+    {
+      events_.push_back({static_cast<Action::EventType>(e->type),
+                         static_cast<Keymap::Keycode>(e->code),
+                         e->keysym});
+    }
+  }
+
+  Action::EventList const&
+  events() const
+  { return events_; }
+
+private:
+  Action::EventList events_;
+};
+
+
+struct WishBundle::Impl
+{
+  Impl(std::string const& file_name);
+
+  bool
+  check_layout();
+
+  SourceBuffer  map_;
+  bool          is_valid_;
+  BundleLayout  layout_;
+};
+
+
+WishBundle::Impl::
+Impl(std::string const& file_name)
+: is_valid_(false)
+, layout_()
+{
+  is_valid_ = SourceBuffer::map_file(file_name, map_)
+           && map_.size() >= sizeof(BundleHeader)
+           && check_layout();
+}
+
+
+/**
+ * Locates the record arrays in the mapped file and makes sure every index in
+ * them stays inside the file, so a damaged bundle is rejected up front rather
+ * than read out of bounds later.
+ */
+bool WishBundle::Impl::
+check_layout()
+{
+  char const* base = map_.data();
+  layout_.header = reinterpret_cast<BundleHeader const*>(base);
+  if (0 != std::memcmp(layout_.header->magic, bundle_magic, sizeof(bundle_magic))
+   || layout_.header->version != bundle_version)
+    return false;
+
+  std::size_t offset = sizeof(BundleHeader);
+  layout_.sources = reinterpret_cast<SourceRecord const*>(base + offset);
+  offset += layout_.header->source_count * sizeof(SourceRecord);
+  layout_.apps = reinterpret_cast<AppRecord const*>(base + offset);
+  offset += layout_.header->app_count * sizeof(AppRecord);
+  layout_.wishes = reinterpret_cast<WishRecord const*>(base + offset);
+  offset += layout_.header->wish_count * sizeof(WishRecord);
+  layout_.events = reinterpret_cast<EventRecord const*>(base + offset);
+  offset += layout_.header->event_count * sizeof(EventRecord);
+  layout_.strings = reinterpret_cast<StringRecord const*>(base + offset);
+  offset += layout_.header->string_count * sizeof(StringRecord);
+  layout_.string_bytes = base + offset;
+  offset += layout_.header->string_bytes;
+  if (offset != map_.size())
+    return false;
+
+  std::uint32_t string_count = layout_.header->string_count;
+  for (std::uint32_t i = 0; i < string_count; ++i)
+  {
+    if (layout_.strings[i].offset > layout_.header->string_bytes
+     || layout_.strings[i].length > layout_.header->string_bytes - layout_.strings[i].offset)
+      return false;
+  }
+  for (std::uint32_t i = 0; i < layout_.header->source_count; ++i)
+  {
+    if (layout_.sources[i].name >= string_count)
+      return false;
+  }
+  for (std::uint32_t i = 0; i < layout_.header->app_count; ++i)
+  {
+    if (layout_.apps[i].name >= string_count
+     || layout_.apps[i].source >= layout_.header->source_count
+     || layout_.apps[i].first_wish > layout_.header->wish_count
+     || layout_.apps[i].wish_count > layout_.header->wish_count - layout_.apps[i].first_wish)
+      return false;
+  }
+  for (std::uint32_t i = 0; i < layout_.header->wish_count; ++i)
+  {
+    WishRecord const& w = layout_.wishes[i];
+    if (w.name >= string_count || w.gesture >= string_count
+     || w.when >= string_count || w.property >= string_count
+     || w.trigger_mode >= string_count
+     || w.first_event > layout_.header->event_count
+     || w.event_count > layout_.header->event_count - w.first_event)
+      return false;
+  }
+  for (std::uint32_t i = 0; i < layout_.header->event_count; ++i)
+  {
+    if (layout_.events[i].type > static_cast<std::uint32_t>(Action::EventType::button_release))
+      return false;
+  }
+  return true;
+}
+
+
+BundleWishBuilder::
+BundleWishBuilder(BundleLayout const& bundle, WishRecord const& record)
+: bundle_(bundle)
+, record_(record)
+{ }
+
+
+std::string BundleWishBuilder::
+name() const
+{ return bundle_.string(record_.name); }
+
+
+std::string BundleWishBuilder::
+gesture() const
+{ return bundle_.string(record_.gesture); }
+
+
+std::string BundleWishBuilder::
+when() const
+{ return bundle_.string(record_.when); }
+
+
+std::string BundleWishBuilder::
+property() const
+{ return bundle_.string(record_.property); }
+
+
+std::string BundleWishBuilder::
+trigger_mode() const
+{ return bundle_.string(record_.trigger_mode); }
+
+
+Action BundleWishBuilder::
+action() const
+{ return Action(BundleActionBuilder(bundle_.events + record_.first_event,
+                                    record_.event_count)); }
+
+
+WishBundle::
+WishBundle(std::string const& file_name)
+: impl_(new Impl(file_name))
+{ }
+
+
+WishBundle::
+~WishBundle()
+{ }
+
+
+bool WishBundle::
+is_valid() const
+{
+  return impl_->is_valid_;
+}
+
+
+/**
+ * Compares the names and content hashes of the raw sources, in order, with
+ * those the bundle was compiled from.
+ */
+bool WishBundle::
+is_current_for(WishSource::RawSourceList const& raw_sources) const
+{
+  if (!impl_->is_valid_ || raw_sources.size() != impl_->layout_.header->source_count)
+    return false;
+
+  for (std::size_t i = 0; i < raw_sources.size(); ++i)
+  {
+    SourceRecord const& source = impl_->layout_.sources[i];
+    StringRecord const& name = impl_->layout_.strings[source.name];
+    if (raw_sources[i].name.size() != name.length
+     || 0 != raw_sources[i].name.compare(0, name.length,
+                                         impl_->layout_.string_bytes + name.offset,
+                                         name.length)
+     || source.hash != fnv1a_hash(raw_sources[i].source.data(),
+                                  raw_sources[i].source.size()))
+      return false;
+  }
+  return true;
+}
+
+
+Wish::Table WishBundle::
+wishes() const
+{
+  return WishSource::merge_wishes(source_wishes());
+}
+
+
+WishSource::SourceWishes WishBundle::
+source_wishes() const
+{
+  WishSource::SourceWishes source_wishes;
+  if (!impl_->is_valid_)
+    return source_wishes;
+
+  BundleLayout const& layout = impl_->layout_;
+  source_wishes.resize(layout.header->source_count);
+  for (std::uint32_t a = 0; a < layout.header->app_count; ++a)
+  {
+    AppRecord const& app = layout.apps[a];
+    Wish::List& wish_list = source_wishes[app.source][layout.string(app.name)];
+    for (std::uint32_t w = app.first_wish; w < app.first_wish + app.wish_count; ++w)
+    {
+      auto wish = std::make_shared<Wish>(BundleWishBuilder(layout, layout.wishes[w]));
+      wish_list[wish->name()] = wish;
+    }
+  }
+  return source_wishes;
+}
+
+} // namespace Ginn
+
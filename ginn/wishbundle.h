@@ -0,0 +1,105 @@
+/**
+ * @file ginn/wishbundle.h
+ * @brief Declarations of the Ginn Wish Bundle module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_WISHBUNDLE_H_
+#define GINN_WISHBUNDLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include "ginn/wish.h"
+#include "ginn/wishsource.h"
+#include <memory>
+#include <string>
+
+
+namespace Ginn
+{
+
+/** Computes the 64-bit FNV-1a hash of a block of bytes. */
+std::uint64_t
+fnv1a_hash(char const* data, std::size_t size);
+
+
+/**
+ * A precompiled, memory-mappable form of the wishes loaded from a set of raw
+ * sources.
+ *
+ * The bundle is a single flat file:  a header, the name and content hash of
+ * each raw source it was compiled from, flat application records for the
+ * wishes of each source, flat wish and action event records, and a table of interned strings the records refer to by
+ * index.  Loading it means mapping the file and walking the records, with no
+ * XML parsing or validation at all.
+ *
+ * A bundle is current only for the very same raw sources, in the same order,
+ * with the same contents, that it was compiled from.
+ */
+class WishBundle
+{
+public:
+  /**
+   * Compiles the wishes of a set of raw sources into a bundle file.
+   * @param[in] file_name      Names the bundle file to write.
+   * @param[in] raw_sources    The raw sources the wishes were loaded from.
+   * @param[in] source_wishes  The wishes loaded from each raw source.
+   *
+   * The file is written under a temporary name and renamed into place, so a
+   * running ginn never maps a half-written bundle.
+   *
+   * @returns true if the bundle was written, false otherwise.
+   */
+  static bool
+  write(std::string const&               file_name,
+        WishSource::RawSourceList const& raw_sources,
+        WishSource::SourceWishes const&  source_wishes);
+
+public:
+  /**
+   * Maps a bundle file into memory.
+   * @param[in] file_name  Names the bundle file to map.
+   */
+  WishBundle(std::string const& file_name);
+
+  ~WishBundle();
+
+  /** Indicates if the bundle was mapped and is well-formed. */
+  bool
+  is_valid() const;
+
+  /** Indicates if the bundle was compiled from exactly these raw sources. */
+  bool
+  is_current_for(WishSource::RawSourceList const& raw_sources) const;
+
+  /** Rebuilds the merged wish table from the bundle records. */
+  Wish::Table
+  wishes() const;
+
+  /** Rebuilds the wishes of each raw source from the bundle records. */
+  WishSource::SourceWishes
+  source_wishes() const;
+
+private:
+  struct Impl;
+
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace Ginn
+
+#endif // GINN_WISHBUNDLE_H_
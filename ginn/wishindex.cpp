@@ -0,0 +1,156 @@
+/**
+ * @file ginn/wishindex.cpp
+ * @brief Definitions of the Ginn Wish Index module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/wishindex.h"
+
+#include <algorithm>
+#include "ginn/application.h"
+#include <iterator>
+
+
+namespace Ginn
+{
+
+namespace
+{
+
+bool
+name_less(Wish::Ptr const& lhs, Wish::Ptr const& rhs)
+{
+  return lhs->name() < rhs->name();
+}
+
+
+/**
+ * Gets the base name of a desktop file without the ".desktop" suffix.
+ *
+ * Wish files usually name applications this way (eg. "evince") while the
+ * desktop id is the full path of the desktop file.
+ */
+std::string
+desktop_basename(std::string const& desktop_id)
+{
+  static const std::string suffix = ".desktop";
+  std::string::size_type begin = desktop_id.rfind('/');
+  begin = (begin == std::string::npos) ? 0 : begin + 1;
+  std::string::size_type end = desktop_id.size();
+  if (end - begin > suffix.size()
+      && desktop_id.compare(end - suffix.size(), suffix.size(), suffix) == 0)
+    end -= suffix.size();
+  return desktop_id.substr(begin, end - begin);
+}
+
+} // anonymous namespace
+
+
+const std::string WishIndex::global_key = "<global>";
+
+
+WishIndex::
+WishIndex()
+{ }
+
+
+/**
+ * Each application's list is built once here so that granting wishes to a
+ * window does no merging at all.
+ */
+WishIndex::
+WishIndex(Wish::Table const& wishes)
+{
+  auto global = wishes.find(global_key);
+  if (global != std::end(wishes))
+  {
+    for (auto const& wish: global->second)
+      global_wishes_.push_back(wish.second);
+    std::sort(std::begin(global_wishes_), std::end(global_wishes_), name_less);
+  }
+
+  keys_.reserve(wishes.size());
+  app_wishes_.reserve(wishes.size());
+  for (auto const& app: wishes)
+  {
+    if (app.first == global_key)
+      continue;
+
+    WishList own;
+    own.reserve(app.second.size());
+    for (auto const& wish: app.second)
+      own.push_back(wish.second);
+    std::sort(std::begin(own), std::end(own), name_less);
+
+    WishList list;
+    list.reserve(own.size() + global_wishes_.size());
+    std::set_union(std::begin(own), std::end(own),
+                   std::begin(global_wishes_), std::end(global_wishes_),
+                   std::back_inserter(list), name_less);
+
+    keys_.emplace(app.first, app_wishes_.size());
+    app_wishes_.push_back(std::move(list));
+  }
+}
+
+
+WishIndex::WishList const* WishIndex::
+probe(std::string const& key) const
+{
+  if (key.empty())
+    return nullptr;
+  auto it = keys_.find(key);
+  if (it == std::end(keys_))
+    return nullptr;
+  return &app_wishes_[it->second];
+}
+
+
+WishIndex::WishList const& WishIndex::
+wishes_for(Application const& app) const
+{
+  WishList const* wishes = probe(app.application_id());
+  if (!wishes)
+    wishes = probe(desktop_basename(app.application_id()));
+  if (!wishes)
+    wishes = probe(app.name());
+  if (!wishes)
+    wishes = probe(app.generic_name());
+  return wishes ? *wishes : global_wishes_;
+}
+
+
+WishIndex::WishList const& WishIndex::
+wishes_for(std::string const& key) const
+{
+  WishList const* wishes = probe(key);
+  return wishes ? *wishes : global_wishes_;
+}
+
+
+Wish::Ptr WishIndex::
+find(WishList const& wishes, std::string const& name)
+{
+  auto it = std::lower_bound(std::begin(wishes), std::end(wishes), name,
+                             [](Wish::Ptr const& wish, std::string const& n) -> bool
+                             { return wish->name() < n; });
+  if (it == std::end(wishes) || (*it)->name() != name)
+    return nullptr;
+  return *it;
+}
+
+} // namespace Ginn
@@ -0,0 +1,97 @@
+/**
+ * @file ginn/wishindex.h
+ * @brief Declarations of the Ginn Wish Index module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_WISHINDEX_H_
+#define GINN_WISHINDEX_H_
+
+#include <cstddef>
+#include "ginn/wish.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace Ginn
+{
+class Application;
+
+/**
+ * A compiled index of a Wish::Table for finding an application's wishes.
+ *
+ * Each application key in the table is interned once into a hash table.  An
+ * application is matched by its desktop id, the base name of its desktop file,
+ * its name, or its generic name, in that order, with one hash probe per key
+ * tried.
+ *
+ * The wishes of each application are kept as a flat list sorted by name, with
+ * the wishes of the "<global>" pseudo-application merged in.  An application
+ * wish overrides a global wish of the same name.  Applications that match no
+ * key get just the global wishes.
+ */
+class WishIndex
+{
+public:
+  /** The wishes of an application, sorted by name. */
+  using WishList = std::vector<Wish::Ptr>;
+
+  /** The key of the wishes that apply to every application. */
+  static const std::string global_key;
+
+public:
+  /** Constructs an empty index. */
+  WishIndex();
+
+  /** Compiles an index of a table of wishes. */
+  explicit
+  WishIndex(Wish::Table const& wishes);
+
+  /** Gets the wishes for an application. */
+  WishList const&
+  wishes_for(Application const& app) const;
+
+  /** Gets the wishes for an application key, or the global wishes. */
+  WishList const&
+  wishes_for(std::string const& key) const;
+
+  /** Gets the number of distinct application keys indexed. */
+  std::size_t
+  size() const
+  { return keys_.size(); }
+
+  /**
+   * Finds a wish by name in a list of wishes.
+   * @returns the wish or nullptr if there is no wish by that name.
+   */
+  static Wish::Ptr
+  find(WishList const& wishes, std::string const& name);
+
+private:
+  WishList const*
+  probe(std::string const& key) const;
+
+private:
+  std::unordered_map<std::string, std::size_t> keys_;
+  std::vector<WishList>                        app_wishes_;
+  WishList                                     global_wishes_;
+};
+
+} // namespace Ginn
+
+#endif // GINN_WISHINDEX_H_
@@ -20,7 +20,7 @@
  */
 #include "ginn/wishsource.h"
 
-#include <fstream>
+#include "ginn/bundledwishsource.h"
 #include "ginn/configuration.h"
 #include "ginn/xmlwishsource.h"
 #include <iostream>
@@ -45,6 +45,21 @@ WishSource::
  */
 WishSource::Ptr WishSource::
 factory(WishSourceConfig const* config)
+{
+  if (!config->wish_bundle_file_name().empty())
+    return Ptr(new BundledWishSource(config));
+  return format_factory(config);
+}
+
+
+/**
+ * Gets the wish source for the configured format.
+ * @param[in] config  A WishSourceConfig
+ *
+ * @returns the wish source object that reads the configured format directly.
+ */
+WishSource::Ptr WishSource::
+format_factory(WishSourceConfig const* config)
 {
   Ptr source;
   switch (config->wish_source_format())
@@ -61,32 +76,56 @@ factory(WishSourceConfig const* config)
 
 
 /**
- * Reads the raw sources from the named files into in-memory buffers.
+ * Maps the raw sources from the named files into memory.
  * @param[in] config  A WishSourceConfig
  *
+ * The files are mapped read-only rather than copied, and the mappings are
+ * released when the last copy of the returned list goes away.  Files that
+ * can not be read are skipped.
+ *
  * @returns a collection of loaded raw wish sources.
  */
 WishSource::RawSourceList WishSource::
 read_raw_sources(WishSourceConfig const* config)
+{
+  return read_raw_sources(config->wish_sources());
+}
+
+
+/**
+ * Maps the raw sources from a list of files into memory.
+ * @param[in] file_names  Names the files to map.
+ *
+ * @returns a collection of loaded raw wish sources.
+ */
+WishSource::RawSourceList WishSource::
+read_raw_sources(WishSourceConfig::SourceNameList const& file_names)
 {
   RawSourceList raw_source_list;
-  for (auto const& file_name: config->wish_sources())
+  raw_source_list.reserve(file_names.size());
+  for (auto const& file_name: file_names)
   {
-    std::ifstream ifs(file_name);
-    if (ifs)
-    {
-      std::string contents;
-      ifs.seekg(0, std::ios::end);
-      contents.resize(ifs.tellg());
-      ifs.seekg(0, std::ios::beg);
-      ifs.read(&contents[0], contents.size());
-      raw_source_list.push_back({file_name, contents});
-    }
+    SourceBuffer contents;
+    if (SourceBuffer::map_file(file_name, contents))
+      raw_source_list.push_back({file_name, std::move(contents)});
   }
 
   return raw_source_list;
 }
 
+
+Wish::Table WishSource::
+merge_wishes(SourceWishes const& source_wishes)
+{
+  Wish::Table wish_table;
+  for (auto const& wishes: source_wishes)
+  {
+    for (auto const& app_wishes: wishes)
+      wish_table[app_wishes.first] = app_wishes.second;
+  }
+  return wish_table;
+}
+
 } // namespace Ginn
 
 
@@ -21,6 +21,7 @@
 #ifndef GINN_WISHSOURCE_H_
 #define GINN_WISHSOURCE_H_
 
+#include "ginn/sourcebuffer.h"
 #include "ginn/wish.h"
 #include "ginn/wishsourceconfig.h"
 #include <memory>
@@ -31,7 +32,6 @@
 namespace Ginn
 {
 class Configuration;
-class Keymap;
 
 /**
  * An interface for Wish sources.
@@ -46,27 +46,66 @@ public:
   /** A memory image of a raw wish source. */
   struct RawSource
   {
-    std::string name;    ///< name of the source
-    std::string source;  ///< the raw source itself
+    std::string  name;    ///< name of the source
+    SourceBuffer source;  ///< the raw source itself
   };
 
   /** A collection of raw sources */
   using RawSourceList = std::vector<RawSource>;
 
+  /** The wishes loaded from each of a collection of raw sources, in order. */
+  using SourceWishes = std::vector<Wish::Table>;
+
 public:
   virtual ~WishSource() = 0;
 
-  /** Creates a concrete WishSource. */
+  /**
+   * Creates a concrete WishSource.
+   *
+   * If a wish bundle is configured, the source loads wishes from the bundle
+   * when it is current.
+   */
   static Ptr
   factory(WishSourceConfig const* config);
 
+  /** Creates a WishSource for the configured format, ignoring any bundle. */
+  static Ptr
+  format_factory(WishSourceConfig const* config);
+
   /** Reads the raw wishes into a buffer. */
   static RawSourceList
   read_raw_sources(WishSourceConfig const* config);
 
-  /** Gets wishes from the source. */
+  /** Reads the raw wishes from the named files into a buffer. */
+  static RawSourceList
+  read_raw_sources(WishSourceConfig::SourceNameList const& file_names);
+
+  /**
+   * Merges the wishes loaded from separate raw sources.
+   *
+   * Later sources replace the wishes of an application given by earlier ones.
+   */
+  static Wish::Table
+  merge_wishes(SourceWishes const& source_wishes);
+
+  /**
+   * Gets wishes from the source.
+   *
+   * The keys of the wishes' actions are kept as keysyms and have to be bound
+   * to keycodes with Wish::resolve_keycodes() once a keymap is available.
+   * This may be called on a thread other than the main thread.
+   */
   virtual Wish::Table
-  get_wishes(RawSourceList const& raw_wishes, Keymap* keymap) = 0;
+  get_wishes(RawSourceList const& raw_wishes) = 0;
+
+  /**
+   * Gets the wishes from each raw source separately.
+   *
+   * This is the same as get_wishes() without the final merge, so the wishes
+   * of a single changed source can be replaced later.
+   */
+  virtual SourceWishes
+  get_source_wishes(RawSourceList const& raw_wishes) = 0;
 };
 
 }
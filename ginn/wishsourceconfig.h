@@ -66,6 +66,10 @@ public:
   /** Gets the name of the wish schema file. */
   virtual std::string const&
   wish_schema_file_name() const = 0;
+
+  /** Gets the name of the compiled wish bundle file, empty for none. */
+  virtual std::string const&
+  wish_bundle_file_name() const = 0;
 };
 
 } // namespace Ginn
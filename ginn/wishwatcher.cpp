@@ -0,0 +1,268 @@
+/**
+ * @file ginn/wishwatcher.cpp
+ * @brief Definitions of the Ginn Wish Watcher module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/wishwatcher.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include "ginn/configuration.h"
+#include <glib.h>
+#include <iostream>
+#include <string>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+
+namespace Ginn
+{
+
+/** How long things have to be quiet before a change is reported. */
+static const guint settle_time_ms = 250;
+
+/** The changes to the watched directories that may affect the wishes. */
+static const std::uint32_t watched_events = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE
+                                          | IN_MOVED_FROM | IN_MOVED_TO
+                                          | IN_DELETE_SELF | IN_MOVE_SELF;
+
+
+/**
+ * A watched directory.
+ *
+ * A directory is either one of the wanted directories, or the nearest existing
+ * ancestor of wanted directories that do not exist yet.  For an ancestor, only
+ * the creation of the next directory on the way to a wanted one matters.
+ */
+struct Watch
+{
+  bool                      is_wanted;  ///< one of the wanted directories
+  std::vector<std::string>  awaited;    ///< subdirectories waited for
+};
+
+
+struct WishWatcher::Impl
+{
+  Impl(Configuration const& config);
+
+  ~Impl();
+
+  static gboolean
+  inotify_gio_event_ready(GIOChannel*, GIOCondition, gpointer pdata);
+
+  static gboolean
+  on_settled(gpointer pdata);
+
+  bool
+  read_events();
+
+  Configuration                   config_;
+  int                             inotify_fd_;
+  GIOChannel*                     iochannel_;
+  guint                           io_watch_;
+  guint                           settle_timeout_;
+  std::unordered_map<int, Watch>  watches_;
+  ChangedCallback                 changed_callback_;
+};
+
+
+WishWatcher::Impl::
+Impl(Configuration const& config)
+: config_(config)
+, inotify_fd_(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+, iochannel_(nullptr)
+, io_watch_(0)
+, settle_timeout_(0)
+{
+  if (inotify_fd_ < 0)
+  {
+    std::cerr << "error watching wish files: " << std::strerror(errno) << "\n";
+    return;
+  }
+  iochannel_ = g_io_channel_unix_new(inotify_fd_);
+  io_watch_ = g_io_add_watch(iochannel_, G_IO_IN, inotify_gio_event_ready, this);
+}
+
+
+WishWatcher::Impl::
+~Impl()
+{
+  if (settle_timeout_)
+    g_source_remove(settle_timeout_);
+  if (iochannel_)
+  {
+    g_source_remove(io_watch_);
+    g_io_channel_shutdown(iochannel_, FALSE, NULL);
+    g_io_channel_unref(iochannel_);
+  }
+  if (inotify_fd_ >= 0)
+    close(inotify_fd_);
+}
+
+
+/**
+ * Drains the pending inotify events.
+ *
+ * In a wanted directory, a change to a wish file or a subdirectory counts.  In
+ * the ancestor of a wanted directory that does not exist yet, only the
+ * creation of the awaited subdirectory does.
+ *
+ * @returns true if any of them could affect the wishes.
+ */
+bool WishWatcher::Impl::
+read_events()
+{
+  bool changed = false;
+  alignas(struct inotify_event) char buffer[4096];
+  ssize_t length;
+  while ((length = read(inotify_fd_, buffer, sizeof(buffer))) > 0)
+  {
+    for (char const* p = buffer; p < buffer + length; )
+    {
+      struct inotify_event const* event = reinterpret_cast<struct inotify_event const*>(p);
+      p += sizeof(struct inotify_event) + event->len;
+      if (event->mask & IN_Q_OVERFLOW)
+      {
+        changed = true;
+        continue;
+      }
+
+      auto watch = watches_.find(event->wd);
+      if (watch == std::end(watches_))
+        continue;
+      std::string name = (event->len > 0) ? event->name : "";
+      if (!watch->second.is_wanted)
+      {
+        if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO))
+         && std::find(std::begin(watch->second.awaited), std::end(watch->second.awaited),
+                      name) != std::end(watch->second.awaited))
+          changed = true;
+      }
+      else if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_ISDIR))
+        changed = true;
+      else if (name.size() > 4 && name.compare(name.size() - 4, 4, ".xml") == 0)
+        changed = true;
+    }
+  }
+  return changed;
+}
+
+
+/**
+ * GLib callback for inotify events on the watched directories.
+ *
+ * The settle timer is restarted on every relevant change.
+ */
+gboolean WishWatcher::Impl::
+inotify_gio_event_ready(GIOChannel*, GIOCondition, gpointer pdata)
+{
+  WishWatcher::Impl* impl = static_cast<WishWatcher::Impl*>(pdata);
+  if (impl->read_events())
+  {
+    if (impl->settle_timeout_)
+      g_source_remove(impl->settle_timeout_);
+    impl->settle_timeout_ = g_timeout_add(settle_time_ms, on_settled, impl);
+  }
+  return TRUE;
+}
+
+
+/**
+ * GLib callback for when the watched directories have been quiet long enough.
+ */
+gboolean WishWatcher::Impl::
+on_settled(gpointer pdata)
+{
+  WishWatcher::Impl* impl = static_cast<WishWatcher::Impl*>(pdata);
+  impl->settle_timeout_ = 0;
+  if (impl->config_.is_verbose_mode())
+    std::cout << "wish files changed\n";
+  if (impl->changed_callback_)
+    impl->changed_callback_();
+  return FALSE;
+}
+
+
+WishWatcher::
+WishWatcher(Configuration const& config)
+: impl_(new Impl(config))
+{ }
+
+
+WishWatcher::
+~WishWatcher()
+{ }
+
+
+void WishWatcher::
+watch(DirectoryList const& directories)
+{
+  if (impl_->inotify_fd_ < 0)
+    return;
+
+  for (auto const& watch: impl_->watches_)
+    inotify_rm_watch(impl_->inotify_fd_, watch.first);
+  impl_->watches_.clear();
+
+  for (auto const& directory: directories)
+  {
+    std::string watched = directory;
+    std::string awaited;
+    int wd = inotify_add_watch(impl_->inotify_fd_, watched.c_str(),
+                               watched_events | IN_ONLYDIR);
+    while (wd < 0 && errno == ENOENT)
+    {
+      std::string::size_type slash = watched.rfind('/');
+      if (slash == std::string::npos || slash + 1 == watched.size())
+        break;
+      awaited = watched.substr(slash + 1);
+      watched.erase(slash ? slash : 1);
+      wd = inotify_add_watch(impl_->inotify_fd_, watched.c_str(),
+                             watched_events | IN_ONLYDIR);
+    }
+    if (wd < 0)
+      continue;
+
+    Watch& watch = impl_->watches_[wd];
+    if (watched == directory)
+      watch.is_wanted = true;
+    else
+      watch.awaited.push_back(awaited);
+    if (impl_->config_.is_verbose_mode())
+    {
+      std::cout << "watching '" << watched << "' for wish changes";
+      if (watched != directory)
+        std::cout << " until '" << directory << "' exists";
+      std::cout << "\n";
+    }
+  }
+}
+
+
+void WishWatcher::
+set_changed_callback(ChangedCallback const& changed_callback)
+{
+  impl_->changed_callback_ = changed_callback;
+}
+
+} // namespace Ginn
+
@@ -0,0 +1,77 @@
+/**
+ * @file ginn/wishwatcher.h
+ * @brief Declarations of the Ginn Wish Watcher module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_WISHWATCHER_H_
+#define GINN_WISHWATCHER_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace Ginn
+{
+class Configuration;
+
+/**
+ * Watches the directories holding wish files for changes.
+ *
+ * A burst of changes, like an editor saving a file or a package installing a
+ * set of them, is reported as a single change once things have been quiet for
+ * a moment.
+ */
+class WishWatcher
+{
+public:
+  /** Signal for when something in the watched directories has changed. */
+  using ChangedCallback = std::function<void()>;
+
+  /** A list of directories. */
+  using DirectoryList = std::vector<std::string>;
+
+public:
+  WishWatcher(Configuration const& config);
+
+  ~WishWatcher();
+
+  /**
+   * Sets the directories to watch, replacing any watched before.
+   *
+   * A directory that does not exist yet has its nearest existing ancestor
+   * watched instead.  Creating a directory there is reported as a change, and
+   * the caller is expected to watch again, which moves the watch one step
+   * closer to the wanted directory until it exists.
+   */
+  void
+  watch(DirectoryList const& directories);
+
+  void
+  set_changed_callback(ChangedCallback const& changed_callback);
+
+private:
+  struct Impl;
+
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace Ginn
+
+#endif // GINN_WISHWATCHER_H_
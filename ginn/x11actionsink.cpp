@@ -84,6 +84,7 @@ public:
       impl->callback_queue_.front()();
       impl->callback_queue_.pop();
     }
+    impl->check_fake_input();
     return TRUE;
   }
 
@@ -110,23 +111,27 @@ public:
     }
   }
 
+  /**
+   * Reports any errors from injected input.
+   *
+   * Fake input requests are sent unchecked, so their errors come back
+   * asynchronously along with the events and get picked up here whenever the
+   * X connection becomes readable.
+   */
   void
-  check_fake_input(xcb_void_cookie_t)
+  check_fake_input()
   {
-#if 0
-    xcb_generic_error_t* e = NULL;
-    xcb_test_fake_input_reply_t* reply = xcb_test_fake_input_reply(connection_,
-                                                                   cookie, &e);
-    if (reply)
+    while (xcb_generic_event_t* event = xcb_poll_for_event(connection_))
     {
-      free(reply);
+      if (event->response_type == 0)
+      {
+        xcb_generic_error_t* e = reinterpret_cast<xcb_generic_error_t*>(event);
+        std::cerr << "error " << (int)e->error_code << " sending input"
+                  << " (request " << (int)e->major_code
+                  << "." << (int)e->minor_code << ")\n";
+      }
+      free(event);
     }
-    if (e)
-    {
-      std::cerr << "XTest version error: " << e->error_code << "\n";
-      free(e);
-    }
-#endif
   }
 
   Configuration       config_;
@@ -172,27 +177,25 @@ perform(Action const& action)
 
   for (auto const& event: action)
   {
-    xcb_void_cookie_t cookie = xcb_test_fake_input_checked(impl_->connection_,
-                                                   type_map.at(event.type),
-                                                   event.code,
-                                                   XCB_CURRENT_TIME,
-                                                   none,
-                                                   0, 0, 0);
-#if 0
-    impl_->callback_queue_.push(std::bind(&Impl::check_fake_input,
-                                          impl_.get(),
-                                          cookie));
-#endif
-    xcb_generic_error_t *err = xcb_request_check(impl_->connection_, cookie);
-    if (err)
-    {
-      std::cerr << "error " << (int)err->error_code << " sending input\n";
-      free(err);
-    }
-    xcb_flush(impl_->connection_);
+    xcb_test_fake_input(impl_->connection_,
+                        type_map.at(event.type),
+                        event.code,
+                        XCB_CURRENT_TIME,
+                        none,
+                        0, 0, 0);
   }
 }
 
 
+/**
+ * Sends all the input events queued by perform() to the X server in one write.
+ */
+void X11ActionSink::
+flush()
+{
+  xcb_flush(impl_->connection_);
+}
+
+
 } // namespace Ginn
 
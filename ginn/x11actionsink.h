@@ -52,6 +52,9 @@ public:
   void
   perform(Action const& action);
 
+  void
+  flush();
+
 private:
   std::unique_ptr<Impl> impl_;
 };
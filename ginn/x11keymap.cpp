@@ -20,96 +20,252 @@
  */
 #include "ginn/x11keymap.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include "ginn/configuration.h"
 #include <glib.h>
 #include <iostream>
-#include "keymap.h"
-#include <map>
 #include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <xcb/xcb.h>
+#include <xcb/xcbext.h>
 
 
 namespace Ginn
 {
 
+/** Maps keysyms to the first keycode that produces them. */
+using KeycodeIndex = std::unordered_map<Keymap::Keysym, Keymap::Keycode>;
+
+
 struct X11Keymap::Impl
 {
-  Impl(Configuration const& config)
-  : config_(config)
-  , pid_(-1)
-  , out_fd_(-1)
-  , err_fd_(-1)
-  { }
-  
-  Configuration                  config_;
-  InitializedCallback            initialized_callback_;
-  GPid                           pid_;
-  gint                           out_fd_;
-  gint                           err_fd_;
-  std::map<std::string, Keycode> keymap_;
+  Impl(Configuration const& config);
+  ~Impl();
+
+  static gboolean
+  xcb_gio_event_ready(GIOChannel*, GIOCondition cond, gpointer pdata);
+
+  void
+  request_mapping();
+
+  bool
+  receive_mapping();
+
+  void
+  handle_events();
+
+  void
+  build_index(xcb_get_keyboard_mapping_reply_t* reply);
+
+  Configuration                       config_;
+  InitializedCallback                 initialized_callback_;
+  ChangedCallback                     changed_callback_;
+  xcb_connection_t*                   connection_;
+  GIOChannel*                         iochannel_;
+  xcb_keycode_t                       min_keycode_;
+  xcb_keycode_t                       max_keycode_;
+  xcb_get_keyboard_mapping_cookie_t   cookie_;
+  bool                                mapping_pending_;
+  bool                                mapping_stale_;
+  bool                                is_initialized_;
+  KeycodeIndex                        keycodes_;
 };
 
 
-static gboolean
-cb_out_watch(GIOChannel* channel, GIOCondition cond, gpointer data)
+X11Keymap::Impl::
+Impl(Configuration const& config)
+: config_(config)
+, connection_(xcb_connect(NULL, NULL))
+, mapping_pending_(false)
+, mapping_stale_(false)
+, is_initialized_(false)
 {
-  gchar *line_in;
-  gsize  size;
-  X11Keymap::Impl* impl = reinterpret_cast<X11Keymap::Impl*>(data);
-
-  if (cond == G_IO_HUP)
+  if (xcb_connection_has_error(connection_))
   {
-    g_io_channel_unref(channel);
-    impl->initialized_callback_();
-    return(FALSE);
+    xcb_disconnect(connection_);
+    throw std::runtime_error("connecting to X server");
   }
 
-  g_io_channel_read_line(channel, &line_in, &size, NULL, NULL);
-  std::string s = line_in;
-  g_free(line_in);
+  xcb_setup_t const* setup = xcb_get_setup(connection_);
+  min_keycode_ = setup->min_keycode;
+  max_keycode_ = setup->max_keycode;
 
-  std::string::size_type blank = s.find(' ');
-  if (blank != std::string::npos)
+  iochannel_ = g_io_channel_unix_new(xcb_get_file_descriptor(connection_));
+  g_io_add_watch(iochannel_,
+                 GIOCondition(G_IO_IN | G_IO_ERR | G_IO_HUP),
+                 xcb_gio_event_ready,
+                 this);
+}
+
+
+X11Keymap::Impl::
+~Impl()
+{
+  g_io_channel_shutdown(iochannel_, FALSE, NULL);
+  g_io_channel_unref(iochannel_);
+  xcb_disconnect(connection_);
+}
+
+
+/**
+ * GIO event handler callback:  watches for keyboard mapping changes and picks
+ * up the keyboard mapping reply once the X server has sent it.
+ *
+ * If the connection is lost before the first mapping arrives, the keymap is
+ * reported as initialized anyway, with no keycodes at all, so the rest of Ginn
+ * is not left waiting for it forever.  A connection lost later keeps the last
+ * mapping received.
+ */
+gboolean X11Keymap::Impl::
+xcb_gio_event_ready(GIOChannel*, GIOCondition cond, gpointer pdata)
+{
+  X11Keymap::Impl* impl = static_cast<X11Keymap::Impl*>(pdata);
+  if (cond & (G_IO_ERR | G_IO_HUP))
   {
-    uint8_t keycode = static_cast<uint8_t>(std::stoi(s.substr(blank+1)));
+    std::cerr << "keymap connection to X server lost";
+    if (xcb_connection_has_error(impl->connection_))
+      std::cerr << " (error " << xcb_connection_has_error(impl->connection_) << ")";
+    std::cerr << "\n";
+    impl->mapping_pending_ = false;
+    impl->mapping_stale_ = false;
+    if (!impl->is_initialized_)
+    {
+      impl->keycodes_.clear();
+      impl->is_initialized_ = true;
+      if (impl->initialized_callback_)
+        impl->initialized_callback_();
+    }
+    return FALSE;
+  }
+
+  impl->handle_events();
+  if (impl->mapping_pending_ && impl->receive_mapping() && !impl->is_initialized_)
+  {
+    impl->is_initialized_ = true;
+    if (impl->initialized_callback_)
+      impl->initialized_callback_();
+  }
+  if (impl->mapping_stale_ && !impl->mapping_pending_)
+    impl->request_mapping();
+  return TRUE;
+}
 
-    std::string::size_type eq = s.find('=', blank+1);
-    std::string::size_type start = s.find_first_not_of("= \t\n", eq);
-    while (start != std::string::npos)
+
+/**
+ * Notes keyboard mapping changes.
+ *
+ * The X server sends a MappingNotify to every client when the keyboard mapping
+ * changes, including when XKB switches layouts or a different keyboard gets
+ * plugged in.  A new mapping gets requested once any outstanding request has
+ * been answered.
+ */
+void X11Keymap::Impl::
+handle_events()
+{
+  while (xcb_generic_event_t* event = xcb_poll_for_event(connection_))
+  {
+    if ((event->response_type & ~0x80) == XCB_MAPPING_NOTIFY)
     {
-      std::string::size_type end = s.find_first_of(" \t\n", start);
-      std::string keysym = s.substr(start, end-start);
-      if (keysym == "ancel")
-      {
-        std::cerr << "==smw> keysym='" << keysym << "' s='" << s << "'\n";
-      }
-      if (keysym != "NoSymbol")
-      {
-        impl->keymap_[keysym] = keycode;
-      }
-      start = s.find_first_not_of(" \t\n", end);
+      xcb_mapping_notify_event_t* mapping = reinterpret_cast<xcb_mapping_notify_event_t*>(event);
+      if (mapping->request == XCB_MAPPING_KEYBOARD)
+        mapping_stale_ = true;
     }
+    free(event);
   }
+}
+
 
-  return(TRUE);
+/**
+ * Asks the X server for the keysyms of all keycodes in a single request.
+ */
+void X11Keymap::Impl::
+request_mapping()
+{
+  cookie_ = xcb_get_keyboard_mapping(connection_,
+                                     min_keycode_,
+                                     max_keycode_ - min_keycode_ + 1);
+  mapping_pending_ = true;
+  mapping_stale_ = false;
+  xcb_flush(connection_);
 }
 
-static gboolean
-cb_err_watch(GIOChannel* channel, GIOCondition cond, gpointer)
+
+/**
+ * Collects the keyboard mapping reply, if it has arrived.
+ * @returns true if the mapping request has been dealt with.
+ */
+bool X11Keymap::Impl::
+receive_mapping()
 {
-  gchar *line_in;
-  gsize  size;
+  void* reply = nullptr;
+  xcb_generic_error_t* e = nullptr;
+  if (!xcb_poll_for_reply(connection_, cookie_.sequence, &reply, &e))
+    return false;
 
-  if (cond == G_IO_HUP)
+  mapping_pending_ = false;
+  if (e)
+  {
+    std::cerr << "error " << (int)e->error_code << " getting keyboard mapping\n";
+    free(e);
+  }
+  if (reply)
   {
-      g_io_channel_unref(channel);
-      return( FALSE );
+    build_index(static_cast<xcb_get_keyboard_mapping_reply_t*>(reply));
+    free(reply);
   }
+  return true;
+}
 
-  g_io_channel_read_line(channel, &line_in, &size, NULL, NULL);
-  std::cerr << __PRETTY_FUNCTION__ << ": '" << line_in << "'\n";
-  g_free(line_in);
 
-  return(TRUE);
+/**
+ * Builds the keysym to keycode index from a keyboard mapping.
+ *
+ * A keysym produced by more than one keycode (or by more than one column of a
+ * keycode) maps to the lowest keycode.
+ *
+ * If this replaces an earlier mapping, the keysyms that have been added,
+ * removed, or moved to another keycode are reported as changed.
+ */
+void X11Keymap::Impl::
+build_index(xcb_get_keyboard_mapping_reply_t* reply)
+{
+  xcb_keysym_t const* keysyms = xcb_get_keyboard_mapping_keysyms(reply);
+  int keysym_count = xcb_get_keyboard_mapping_keysyms_length(reply);
+  int per_keycode = reply->keysyms_per_keycode;
+
+  KeycodeIndex keycodes;
+  for (int i = 0; per_keycode > 0 && i < keysym_count; ++i)
+  {
+    if (keysyms[i] != no_symbol)
+      keycodes.emplace(keysyms[i], static_cast<Keycode>(min_keycode_ + i / per_keycode));
+  }
+
+  KeysymList changed;
+  if (is_initialized_)
+  {
+    for (auto const& k: keycodes)
+    {
+      auto old = keycodes_.find(k.first);
+      if (old == keycodes_.end() || old->second != k.second)
+        changed.push_back(k.first);
+    }
+    for (auto const& k: keycodes_)
+    {
+      if (keycodes.find(k.first) == keycodes.end())
+        changed.push_back(k.first);
+    }
+    std::sort(std::begin(changed), std::end(changed));
+  }
+  keycodes_ = std::move(keycodes);
+
+  if (config_.is_verbose_mode())
+    std::cout << __PRETTY_FUNCTION__ << " " << keycodes_.size()
+              << " keysyms mapped, " << changed.size() << " changed\n";
+
+  if (!changed.empty() && changed_callback_)
+    changed_callback_(changed);
 }
 
 
@@ -117,27 +273,7 @@ X11Keymap::
 X11Keymap(Configuration const& config)
 : impl_(new Impl(config))
 {
-  char const* argv[] = { "/usr/bin/xmodmap", "xmodmap", "-pke", NULL };
-  gboolean bstat = g_spawn_async_with_pipes(NULL,
-                                            (gchar**)argv,
-                                            NULL,
-                                            G_SPAWN_FILE_AND_ARGV_ZERO,
-                                            NULL,
-                                            NULL,
-                                            &impl_->pid_,
-                                            NULL,
-                                            &impl_->out_fd_,
-                                            &impl_->err_fd_,
-                                            NULL);
-  if (!bstat)
-  {
-    throw std::runtime_error("spawn failed");
-  }
-
-  GIOChannel* out_ch = g_io_channel_unix_new(impl_->out_fd_);
-  GIOChannel* err_ch = g_io_channel_unix_new(impl_->err_fd_);
-  g_io_add_watch(out_ch, GIOCondition(G_IO_IN | G_IO_HUP), cb_out_watch, impl_.get());
-  g_io_add_watch(err_ch, GIOCondition(G_IO_IN | G_IO_HUP), (GIOFunc)cb_err_watch, impl_.get());
+  impl_->request_mapping();
 
   if (impl_->config_.is_verbose_mode())
     std::cout << __FUNCTION__ << " created\n";
@@ -157,11 +293,18 @@ set_initialized_callback(InitializedCallback const& initialized_callback)
 }
 
 
+void X11Keymap::
+set_changed_callback(ChangedCallback const& changed_callback)
+{
+  impl_->changed_callback_ = changed_callback;
+}
+
+
 Keymap::Keycode X11Keymap::
-to_keycode(std::string const& keysym_name) const
+to_keycode(Keysym keysym) const
 {
-  auto it = impl_->keymap_.find(keysym_name);
-  if (it != impl_->keymap_.end())
+  auto it = impl_->keycodes_.find(keysym);
+  if (it != impl_->keycodes_.end())
   {
     return it->second;
   }
@@ -169,4 +312,3 @@ to_keycode(std::string const& keysym_name) const
 }
 
 } // namespace Ginn
-
@@ -40,11 +40,16 @@ public:
 
   ~X11Keymap();
 
+  using Keymap::to_keycode;
+
   void
   set_initialized_callback(InitializedCallback const& initialized_callback);
 
+  void
+  set_changed_callback(ChangedCallback const& changed_callback);
+
   Keycode
-  to_keycode(std::string const& keysym_name) const;
+  to_keycode(Keysym keysym) const;
 
 private:
   std::unique_ptr<Impl> impl_;
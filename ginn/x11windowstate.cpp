@@ -0,0 +1,392 @@
+/**
+ * @file ginn/x11windowstate.cpp
+ * @brief Implementation of the Ginn X11 window state module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/x11windowstate.h"
+
+#include <cstdlib>
+#include <cstring>
+#include "ginn/configuration.h"
+#include <glib.h>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <xcb/xcb.h>
+
+
+namespace Ginn
+{
+
+const std::uint32_t X11WindowState::all_desktops;
+
+
+struct X11WindowState::Impl
+{
+  /** What is known of a watched window. */
+  struct State
+  {
+    bool          is_hidden_;
+    std::uint32_t desktop_;
+  };
+
+  using StateIndex = std::unordered_map<Window::Id, State>;
+  using WindowIdSet = std::unordered_set<Window::Id>;
+
+  Impl(Configuration const& config);
+  ~Impl();
+
+  static gboolean
+  xcb_gio_event_ready(GIOChannel*, GIOCondition cond, gpointer pdata);
+
+  void
+  intern_atoms();
+
+  void
+  handle_events();
+
+  void
+  read_states(std::vector<Window::Id> const& window_ids, bool read_current_desktop);
+
+  bool
+  is_on_screen(State const& state) const;
+
+  Configuration     config_;
+  ChangedCallback   changed_callback_;
+  xcb_connection_t* connection_;
+  GIOChannel*       iochannel_;
+  xcb_window_t      root_;
+  xcb_atom_t        net_wm_state_;
+  xcb_atom_t        net_wm_state_hidden_;
+  xcb_atom_t        net_wm_desktop_;
+  xcb_atom_t        net_current_desktop_;
+  std::uint32_t     current_desktop_;
+  StateIndex        states_;
+};
+
+
+X11WindowState::Impl::
+Impl(Configuration const& config)
+: config_(config)
+, connection_(xcb_connect(NULL, NULL))
+, current_desktop_(all_desktops)
+{
+  if (xcb_connection_has_error(connection_))
+  {
+    xcb_disconnect(connection_);
+    throw std::runtime_error("connecting to X server");
+  }
+
+  root_ = xcb_setup_roots_iterator(xcb_get_setup(connection_)).data->root;
+  intern_atoms();
+
+  uint32_t event_mask = XCB_EVENT_MASK_PROPERTY_CHANGE;
+  xcb_change_window_attributes(connection_, root_, XCB_CW_EVENT_MASK, &event_mask);
+  read_states({}, true);
+
+  iochannel_ = g_io_channel_unix_new(xcb_get_file_descriptor(connection_));
+  g_io_add_watch(iochannel_,
+                 GIOCondition(G_IO_IN | G_IO_ERR | G_IO_HUP),
+                 xcb_gio_event_ready,
+                 this);
+}
+
+
+X11WindowState::Impl::
+~Impl()
+{
+  g_io_channel_shutdown(iochannel_, FALSE, NULL);
+  g_io_channel_unref(iochannel_);
+  xcb_disconnect(connection_);
+}
+
+
+/**
+ * Looks up the EWMH atoms, all in a single round trip.
+ */
+void X11WindowState::Impl::
+intern_atoms()
+{
+  static char const* const names[] = {
+    "_NET_WM_STATE",
+    "_NET_WM_STATE_HIDDEN",
+    "_NET_WM_DESKTOP",
+    "_NET_CURRENT_DESKTOP"
+  };
+  xcb_atom_t* atoms[] = {
+    &net_wm_state_,
+    &net_wm_state_hidden_,
+    &net_wm_desktop_,
+    &net_current_desktop_
+  };
+
+  std::vector<xcb_intern_atom_cookie_t> cookies;
+  for (auto name: names)
+    cookies.push_back(xcb_intern_atom(connection_, 0, strlen(name), name));
+  for (std::size_t i = 0; i < cookies.size(); ++i)
+  {
+    *atoms[i] = XCB_ATOM_NONE;
+    xcb_intern_atom_reply_t* reply = xcb_intern_atom_reply(connection_, cookies[i], NULL);
+    if (reply)
+    {
+      *atoms[i] = reply->atom;
+      free(reply);
+    }
+  }
+}
+
+
+/**
+ * GIO event handler callback:  picks up changes in the watched windows' state.
+ *
+ * If the connection to the X server is lost the windows keep the last state
+ * read.
+ */
+gboolean X11WindowState::Impl::
+xcb_gio_event_ready(GIOChannel*, GIOCondition cond, gpointer pdata)
+{
+  X11WindowState::Impl* impl = static_cast<X11WindowState::Impl*>(pdata);
+  if (cond & (G_IO_ERR | G_IO_HUP))
+  {
+    std::cerr << "window state connection to X server lost";
+    if (xcb_connection_has_error(impl->connection_))
+      std::cerr << " (error " << xcb_connection_has_error(impl->connection_) << ")";
+    std::cerr << "\n";
+    return FALSE;
+  }
+
+  impl->handle_events();
+  return TRUE;
+}
+
+
+/**
+ * Notes the property changes that could move windows on or off screen, then
+ * reads the changed properties back and reports the windows that did.
+ *
+ * Reading the properties back can leave more events queued by xcb, where the
+ * GIO watch does not see them, so the events are drained until none are left.
+ */
+void X11WindowState::Impl::
+handle_events()
+{
+  while (true)
+  {
+    WindowIdSet changed_windows;
+    bool current_desktop_changed = false;
+    while (xcb_generic_event_t* event = xcb_poll_for_event(connection_))
+    {
+      if ((event->response_type & ~0x80) == XCB_PROPERTY_NOTIFY)
+      {
+        auto property = reinterpret_cast<xcb_property_notify_event_t*>(event);
+        if (property->window == root_)
+        {
+          if (property->atom == net_current_desktop_)
+            current_desktop_changed = true;
+        }
+        else if (property->atom == net_wm_state_ || property->atom == net_wm_desktop_)
+        {
+          if (states_.find(property->window) != states_.end())
+            changed_windows.insert(property->window);
+        }
+      }
+      free(event);
+    }
+    if (changed_windows.empty() && !current_desktop_changed)
+      return;
+
+    WindowIdSet was_on_screen;
+    for (auto const& state: states_)
+    {
+      if (is_on_screen(state.second))
+        was_on_screen.insert(state.first);
+    }
+
+    read_states({std::begin(changed_windows), std::end(changed_windows)},
+                current_desktop_changed);
+
+    std::vector<Window::Id> moved_windows;
+    for (auto const& state: states_)
+    {
+      if (is_on_screen(state.second) != (was_on_screen.count(state.first) > 0))
+        moved_windows.push_back(state.first);
+    }
+    if (config_.is_verbose_mode())
+      std::cout << __FUNCTION__ << ": " << moved_windows.size()
+                << " windows went on or off screen\n";
+    for (auto window_id: moved_windows)
+    {
+      if (changed_callback_)
+        changed_callback_(window_id);
+    }
+  }
+}
+
+
+/**
+ * Reads the state of some windows, and optionally the current workspace, all
+ * in a single round trip.
+ *
+ * A window that is gone or has no state properties keeps the defaults: not
+ * minimized and on all workspaces.
+ */
+void X11WindowState::Impl::
+read_states(std::vector<Window::Id> const& window_ids, bool read_current_desktop)
+{
+  static const uint32_t max_atoms = 32;
+
+  xcb_get_property_cookie_t current_desktop_cookie = { 0 };
+  if (read_current_desktop)
+    current_desktop_cookie = xcb_get_property(connection_, 0, root_,
+                                              net_current_desktop_,
+                                              XCB_ATOM_CARDINAL, 0, 1);
+
+  std::vector<std::pair<xcb_get_property_cookie_t, xcb_get_property_cookie_t>> cookies;
+  cookies.reserve(window_ids.size());
+  for (auto window_id: window_ids)
+  {
+    cookies.push_back({xcb_get_property(connection_, 0, window_id,
+                                        net_wm_state_, XCB_ATOM_ATOM,
+                                        0, max_atoms),
+                       xcb_get_property(connection_, 0, window_id,
+                                        net_wm_desktop_, XCB_ATOM_CARDINAL,
+                                        0, 1)});
+  }
+
+  if (read_current_desktop)
+  {
+    current_desktop_ = all_desktops;
+    xcb_get_property_reply_t* reply = xcb_get_property_reply(connection_,
+                                                             current_desktop_cookie,
+                                                             NULL);
+    if (reply)
+    {
+      if (xcb_get_property_value_length(reply) >= 4)
+        current_desktop_ = *static_cast<uint32_t*>(xcb_get_property_value(reply));
+      free(reply);
+    }
+  }
+
+  for (std::size_t i = 0; i < window_ids.size(); ++i)
+  {
+    State state { false, all_desktops };
+
+    xcb_get_property_reply_t* reply = xcb_get_property_reply(connection_,
+                                                             cookies[i].first,
+                                                             NULL);
+    if (reply)
+    {
+      auto atoms = static_cast<xcb_atom_t*>(xcb_get_property_value(reply));
+      int atom_count = xcb_get_property_value_length(reply) / sizeof(xcb_atom_t);
+      for (int j = 0; j < atom_count; ++j)
+      {
+        if (atoms[j] == net_wm_state_hidden_)
+          state.is_hidden_ = true;
+      }
+      free(reply);
+    }
+
+    reply = xcb_get_property_reply(connection_, cookies[i].second, NULL);
+    if (reply)
+    {
+      if (xcb_get_property_value_length(reply) >= 4)
+        state.desktop_ = *static_cast<uint32_t*>(xcb_get_property_value(reply));
+      free(reply);
+    }
+
+    states_[window_ids[i]] = state;
+  }
+}
+
+
+bool X11WindowState::Impl::
+is_on_screen(State const& state) const
+{
+  return X11WindowState::is_on_screen(state.is_hidden_,
+                                      state.desktop_,
+                                      current_desktop_);
+}
+
+
+X11WindowState::
+X11WindowState(Configuration const& config)
+: impl_(new Impl(config))
+{
+  if (impl_->config_.is_verbose_mode())
+    std::cout << __FUNCTION__ << " created\n";
+}
+
+
+X11WindowState::
+~X11WindowState()
+{
+}
+
+
+void X11WindowState::
+set_changed_callback(ChangedCallback const& changed_callback)
+{
+  impl_->changed_callback_ = changed_callback;
+}
+
+
+/**
+ * Asks for the watched windows' property changes to be reported before their
+ * properties are read, so no change can slip in between.  Any events that
+ * arrived while waiting for the replies are dealt with at once.
+ */
+void X11WindowState::
+watch(std::vector<Window::Id> const& window_ids)
+{
+  std::vector<Window::Id> new_windows;
+  for (auto window_id: window_ids)
+  {
+    if (impl_->states_.find(window_id) == impl_->states_.end())
+      new_windows.push_back(window_id);
+  }
+  if (new_windows.empty())
+    return;
+
+  uint32_t event_mask = XCB_EVENT_MASK_PROPERTY_CHANGE;
+  for (auto window_id: new_windows)
+    xcb_change_window_attributes(impl_->connection_, window_id,
+                                 XCB_CW_EVENT_MASK, &event_mask);
+  impl_->read_states(new_windows, false);
+  impl_->handle_events();
+}
+
+
+void X11WindowState::
+unwatch(Window::Id window_id)
+{
+  impl_->states_.erase(window_id);
+}
+
+
+bool X11WindowState::
+is_on_screen(Window::Id window_id) const
+{
+  auto it = impl_->states_.find(window_id);
+  if (it == impl_->states_.end())
+    return true;
+  return impl_->is_on_screen(it->second);
+}
+
+} // namespace Ginn
@@ -0,0 +1,103 @@
+/**
+ * @file ginn/x11windowstate.h
+ * @brief Interface to the Ginn X11 window state module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GINN_X11WINDOWSTATE_H_
+#define GINN_X11WINDOWSTATE_H_
+
+#include <cstdint>
+#include <functional>
+#include "ginn/window.h"
+#include <memory>
+#include <vector>
+
+
+namespace Ginn
+{
+class Configuration;
+
+/**
+ * Tracks whether application windows are actually on screen.
+ *
+ * A window is on screen unless it is minimized (its _NET_WM_STATE includes
+ * _NET_WM_STATE_HIDDEN) or it lives on a workspace other than the current one
+ * (its _NET_WM_DESKTOP differs from the root window's _NET_CURRENT_DESKTOP).
+ * The properties are read when a window is first watched and again whenever
+ * the X server reports they have changed.
+ *
+ * A window whose state could not be read counts as on screen.
+ */
+class X11WindowState
+{
+public:
+  struct Impl;
+
+  /** Called with the id of a watched window that went on or off screen. */
+  using ChangedCallback = std::function<void(Window::Id)>;
+
+  /** The _NET_WM_DESKTOP of a window shown on all workspaces. */
+  static const std::uint32_t all_desktops = 0xffffffff;
+
+  /**
+   * Indicates if a window in the given state is on screen.
+   * @param[in] is_hidden        The window is minimized.
+   * @param[in] desktop          The workspace the window is on.
+   * @param[in] current_desktop  The workspace being shown, or all_desktops if
+   *                             the window manager does not say.
+   */
+  static bool
+  is_on_screen(bool is_hidden, std::uint32_t desktop, std::uint32_t current_desktop)
+  {
+    return !is_hidden
+        && (desktop == all_desktops
+         || current_desktop == all_desktops
+         || desktop == current_desktop);
+  }
+
+public:
+  X11WindowState(Configuration const& config);
+
+  ~X11WindowState();
+
+  void
+  set_changed_callback(ChangedCallback const& changed_callback);
+
+  /**
+   * Starts tracking some windows.
+   *
+   * The states of all the windows are requested together, so watching a batch
+   * of windows costs a single round trip to the X server.
+   */
+  void
+  watch(std::vector<Window::Id> const& window_ids);
+
+  /** Stops tracking a window. */
+  void
+  unwatch(Window::Id window_id);
+
+  bool
+  is_on_screen(Window::Id window_id) const;
+
+private:
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace Ginn
+
+#endif // GINN_X11WINDOWSTATE_H_
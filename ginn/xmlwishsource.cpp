@@ -21,9 +21,12 @@
 #include "ginn/xmlwishsource.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <exception>
 #include "ginn/actionbuilder.h"
 #include "ginn/keymap.h"
+#include "ginn/keysym.h"
 #include "ginn/wishbuilder.h"
 #include "ginn/wish.h"
 #include "ginn/wishsourceconfig.h"
@@ -31,7 +34,10 @@
 #include <iterator>
 #include <libxml/xmlreader.h>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 
 /**
@@ -60,19 +66,11 @@ public:
 };
 
 template<>
-class default_delete<xmlRelaxNGValidCtxt>
+class default_delete<xmlTextReader>
 {
 public:
-  void operator()(xmlRelaxNGValidCtxt* p)
-  { xmlRelaxNGFreeValidCtxt(p); }
-};
-
-template<>
-class default_delete<xmlDoc>
-{
-public:
-  void operator()(xmlDoc* p)
-  { xmlFreeDoc(p); }
+  void operator()(xmlTextReader* p)
+  { xmlFreeTextReader(p); }
 };
 
 } // namespace std
@@ -82,8 +80,64 @@ namespace Ginn
 
 using ParserCtxtPtr = std::unique_ptr<xmlRelaxNGParserCtxt>;
 using SchemaPtr     = std::unique_ptr<xmlRelaxNG>;
-using ValidatorPtr  = std::unique_ptr<xmlRelaxNGValidCtxt>;
-using XmlDocPtr     = std::unique_ptr<xmlDoc>;
+using XmlReaderPtr  = std::unique_ptr<xmlTextReader>;
+
+/**
+ * An attribute or content string handed out by libxml2, freed when it goes
+ * out of scope.
+ */
+class XmlString
+{
+public:
+  explicit XmlString(xmlChar* str)
+  : str_(str)
+  { }
+
+  XmlString(XmlString const&) = delete;
+  XmlString& operator=(XmlString const&) = delete;
+
+  ~XmlString()
+  { xmlFree(str_); }
+
+  explicit operator bool() const
+  { return str_ != nullptr; }
+
+  char const*
+  c_str() const
+  { return reinterpret_cast<char const*>(str_); }
+
+private:
+  xmlChar* str_;
+};
+
+
+/**
+ * Gets an attribute of the current element.
+ * @param[in]  reader The XML reader positioned on the element.
+ * @param[in]  name   The name of the attribute.
+ * @param[out] value  The value of the attribute, left alone if it is missing.
+ *
+ * @returns true if the element has the attribute, false otherwise.
+ */
+static bool
+read_attribute(xmlTextReaderPtr reader, char const* name, std::string& value)
+{
+  XmlString attribute(xmlTextReaderGetAttribute(reader, (xmlChar const*)name));
+  if (!attribute)
+    return false;
+  value = attribute.c_str();
+  return true;
+}
+
+
+/**
+ * Checks if the reader is positioned on an element of a given name.
+ */
+static bool
+is_element(xmlTextReaderPtr reader, char const* name)
+{
+  return 0 == strcmp((char const*)xmlTextReaderConstLocalName(reader), name);
+}
 
   
 /**
@@ -92,7 +146,7 @@ using XmlDocPtr     = std::unique_ptr<xmlDoc>;
 struct XmlActionBuilder
 : public ActionBuilder
 {
-  XmlActionBuilder(xmlNodePtr const& node, Keymap* keymap);
+  XmlActionBuilder(xmlTextReaderPtr reader);
 
   Action::EventList const&
   events() const;
@@ -102,52 +156,58 @@ private:
 };
 
 
+/**
+ * Looks up a keysym name from a wish, complaining if it's not recognized.
+ */
+static Keymap::Keysym
+to_keysym(char const* name)
+{
+  Keymap::Keysym keysym = keysym_from_name(name);
+  if (keysym == Keymap::no_symbol)
+    std::cerr << "unrecognized keysym name '" << name << "'\n";
+  return keysym;
+}
+
+
+/**
+ * Unpacks a <button> or <key> element into its events.
+ * @param[in] reader  The XML reader, positioned on the element.
+ *
+ * Keys are recorded by keysym only:  their keycodes are filled in later, once
+ * the keymap is available.
+ */
 XmlActionBuilder::
-XmlActionBuilder(xmlNodePtr const& node, Keymap* keymap)
+XmlActionBuilder(xmlTextReaderPtr reader)
 {
   Action::EventList tail;
 
-  char const* mod1 = (char const*)xmlGetProp(node, (xmlChar const*)"modifier1");
-  if (mod1)
+  for (char const* modifier: { "modifier1", "modifier2" })
   {
-    events_.push_back({Action::EventType::key_press, keymap->to_keycode(mod1)});
-    tail.push_back({Action::EventType::key_release, keymap->to_keycode(mod1)});
-  }
-
-  char const* mod2 = (char const*)xmlGetProp(node, (xmlChar const*)"modifier2");
-  if (mod2)
-  {
-    events_.push_back({Action::EventType::key_press, keymap->to_keycode(mod2)});
-    tail.push_back({Action::EventType::key_release, keymap->to_keycode(mod2)});
+    XmlString mod(xmlTextReaderGetAttribute(reader, (xmlChar const*)modifier));
+    if (mod)
+    {
+      Keymap::Keysym keysym = to_keysym(mod.c_str());
+      events_.push_back({Action::EventType::key_press, 0, keysym});
+      tail.push_back({Action::EventType::key_release, 0, keysym});
+    }
   }
 
-  if (0 == strcmp((char const*)node->name, "button"))
+  bool is_button = is_element(reader, "button");
+  XmlString content(xmlTextReaderReadString(reader));
+  if (content && *content.c_str())
   {
-    for (xmlNodePtr child = node->children; child; child = child->next)
+    if (is_button)
     {
-      if (child->type == XML_TEXT_NODE)
-      {
-        // @todo use something better to convert content to keycode
-        std::string keysym(reinterpret_cast<char const*>(child->content));
-        events_.push_back({Action::EventType::button_press,
-                           static_cast<Keymap::Keycode>(std::stoi(keysym))});
-        tail.push_back({Action::EventType::button_release,
-                        static_cast<Keymap::Keycode>(std::stoi(keysym))});
-      }
+      // @todo use something better to convert content to keycode
+      Keymap::Keycode button = static_cast<Keymap::Keycode>(std::stoi(content.c_str()));
+      events_.push_back({Action::EventType::button_press, button, Keymap::no_symbol});
+      tail.push_back({Action::EventType::button_release, button, Keymap::no_symbol});
     }
-  }
-  else if (0 == strcmp((char const*)node->name, "key"))
-  {
-    for (xmlNodePtr child = node->children; child; child = child->next)
+    else
     {
-      if (child->type == XML_TEXT_NODE)
-      {
-        std::string keysym(reinterpret_cast<char const*>(child->content));
-        events_.push_back({Action::EventType::key_press,
-                          keymap->to_keycode(keysym)});
-        tail.push_back({Action::EventType::key_release,
-                        keymap->to_keycode(keysym)});
-      }
+      Keymap::Keysym keysym = to_keysym(content.c_str());
+      events_.push_back({Action::EventType::key_press, 0, keysym});
+      tail.push_back({Action::EventType::key_release, 0, keysym});
     }
   }
 
@@ -163,16 +223,22 @@ events() const
 
 
 /**
- * Transforms a wish XML node into a Wish object.
+ * Transforms a wish XML element into a Wish object.
+ *
+ * The builder is created on the <wish> element and then fed the elements
+ * inside it one at a time as the reader comes across them.
  */
 struct XmlWishBuilder
 : public WishBuilder
 {
-  XmlWishBuilder(xmlNodePtr const& node, Keymap* keymap);
+  XmlWishBuilder(xmlTextReaderPtr reader);
 
   ~XmlWishBuilder()
   { }
 
+  void
+  read_element(xmlTextReaderPtr reader);
+
   std::string
   name() const
   { return gesture_ + std::to_string(touches_) + property_; }
@@ -201,10 +267,30 @@ struct XmlWishBuilder
   max() const
   { return max_; }
 
+  std::string
+  trigger_mode() const
+  { return trigger_mode_; }
+
+  int
+  min_interval() const
+  { return min_interval_; }
+
+  float
+  rearm_margin() const
+  { return rearm_margin_; }
+
+  unsigned int
+  max_fires() const
+  { return max_fires_; }
+
   Action
   action() const
   { return action_; }
 
+private:
+  void
+  read_trigger(xmlTextReaderPtr reader);
+
 private:
   std::string gesture_;
   int         touches_;
@@ -212,58 +298,79 @@ private:
   std::string property_;
   float       min_;
   float       max_;
+  std::string trigger_mode_;
+  int         min_interval_;
+  float       rearm_margin_;
+  unsigned    max_fires_;
   Action      action_;
 };
 
 
 /**
- * Unpacks the WIsh DOM into separate values that can be used to build a Wish.
- * @param[in] app_name The name of the application (or <global>).
- * @param[in] node     The wish XML DOM.
+ * Starts building a wish from the attributes of a <wish> element.
+ * @param[in] reader  The XML reader, positioned on the <wish> element.
  */
 XmlWishBuilder::
-XmlWishBuilder(xmlNodePtr const& node, Keymap* keymap)
-: gesture_((char const*)xmlGetProp(node, (xmlChar const*)"gesture"))
-, touches_(std::stoi((char const*)xmlGetProp(node, (xmlChar const*)"fingers")))
+XmlWishBuilder(xmlTextReaderPtr reader)
+: touches_(0)
 , min_(0.0f)
 , max_(0.0f)
+, min_interval_(0)
+, rearm_margin_(-1.0f)
+, max_fires_(0)
+{
+  read_attribute(reader, "gesture", gesture_);
+  std::string fingers;
+  if (read_attribute(reader, "fingers", fingers))
+    touches_ = std::stoi(fingers);
+}
+
+
+/**
+ * Unpacks an element found inside the <wish> element.
+ * @param[in] reader  The XML reader, positioned on the element.
+ */
+void XmlWishBuilder::
+read_element(xmlTextReaderPtr reader)
 {
-  for (xmlNodePtr child = node->children; child; child = child->next)
+  if (is_element(reader, "action"))
   {
-    if (child->type == XML_ELEMENT_NODE
-     && 0 == strcmp((char const*)child->name, "action"))
-    {
-      when_ = (char const*)xmlGetProp(child, (xmlChar const*)"when");
-      for (xmlNodePtr anode = child->children; anode; anode = anode->next)
-      {
-        if (anode->type == XML_ELEMENT_NODE)
-        {
-          if (0 == strcmp((char const*)anode->name, "trigger"))
-          {
-            property_ = (char const*)xmlGetProp(anode, (xmlChar const*)"prop");
-            char const* smin = (char const*)xmlGetProp(anode, (xmlChar const*)"min");
-            if (smin)
-            {
-              min_ = std::stof(smin);
-            }
-            char const* smax = (char const*)xmlGetProp(anode, (xmlChar const*)"max");
-            if (smax)
-            {
-              max_ = std::stof(smax);
-            }
-          }
-          else if (0 == strcmp((char const*)anode->name, "button")
-                || 0 == strcmp((char const*)anode->name, "key"))
-          {
-            action_ = Action(XmlActionBuilder(anode, keymap));
-          }
-        }
-      }
-    }
+    read_attribute(reader, "when", when_);
+  }
+  else if (is_element(reader, "trigger"))
+  {
+    read_trigger(reader);
+  }
+  else if (is_element(reader, "button") || is_element(reader, "key"))
+  {
+    action_ = Action(XmlActionBuilder(reader));
   }
 }
 
 
+/**
+ * Unpacks the attributes of a <trigger> element.
+ * @param[in] reader  The XML reader, positioned on the <trigger> element.
+ */
+void XmlWishBuilder::
+read_trigger(xmlTextReaderPtr reader)
+{
+  std::string value;
+  read_attribute(reader, "prop", property_);
+  if (read_attribute(reader, "min", value))
+    min_ = std::stof(value);
+  if (read_attribute(reader, "max", value))
+    max_ = std::stof(value);
+  read_attribute(reader, "mode", trigger_mode_);
+  if (read_attribute(reader, "interval", value))
+    min_interval_ = std::stoi(value);
+  if (read_attribute(reader, "rearm", value))
+    rearm_margin_ = std::stof(value);
+  if (read_attribute(reader, "limit", value))
+    max_fires_ = std::stoul(value);
+}
+
+
 /**
  * Internal implementation of the XML wish source.
  */
@@ -280,7 +387,6 @@ struct XmlWishSource::Impl
   WishSourceConfig const*  config_;
   ParserCtxtPtr            ctxt_;
   SchemaPtr                schema_;
-  ValidatorPtr             vctxt_;
 };
 
 
@@ -289,12 +395,13 @@ XmlWishSource::Impl::
 Impl(WishSourceConfig const* config)
 : config_(config)
 {
+  xmlInitParser();
+
   std::string const& schema_file_name = config_->wish_schema_file_name();
   if (schema_file_name != WishSourceConfig::WISH_NO_VALIDATE)
   {
     ctxt_ = ParserCtxtPtr(xmlRelaxNGNewParserCtxt(schema_file_name.c_str()));
     schema_ = SchemaPtr(xmlRelaxNGParse(ctxt_.get()));
-    vctxt_ = ValidatorPtr(xmlRelaxNGNewValidCtxt(schema_.get()));
   }
 }
 
@@ -336,132 +443,288 @@ XmlWishSource::
 
 
 /**
- * Processes a collection of wishes targeted to a specific application
- * (including the global <global> application).
- * @param[in]  node      An XML node to process.
- * @param[out] wishes    The current collection of processed wishes.
+ * Builds a Wish::Table from the elements of a wish document as they stream
+ * past.
+ *
+ * Only the wish currently being read and the list of wishes for the current
+ * application are held in memory, rather than a DOM of the whole document.
  */
-static Wish::List
-process_application_node(xmlNodePtr node, Keymap* keymap)
+class XmlWishReader
 {
-  Wish::List wish_list;
-  while (node)
-  {
-    if (node->type == XML_ELEMENT_NODE
-     && 0 == strcmp((char const*)node->name, "wish"))
-    {
-      auto wish = std::make_shared<Wish>(XmlWishBuilder(node, keymap));
-      wish_list[wish->name()] = wish;
-    }
-    node = node->next;
-  }
-  return wish_list;
-}
+public:
+  XmlWishReader(std::string const& source_name)
+  : source_name_(source_name)
+  , app_depth_(-1)
+  , wish_depth_(-1)
+  { }
+
+  bool
+  start_element(xmlTextReaderPtr reader);
+
+  void
+  end_element(xmlTextReaderPtr reader);
+
+  Wish::Table&
+  wish_table()
+  { return wish_table_; }
+
+private:
+  std::string                     source_name_;
+  Wish::Table                     wish_table_;
+  std::string                     app_name_;
+  int                             app_depth_;
+  Wish::List                      wish_list_;
+  int                             wish_depth_;
+  std::unique_ptr<XmlWishBuilder> wish_;
+};
 
 
 /**
- * Processes the top-level <ginn> node of the wish XML.
- * @param[in]  node    An XML node to process.
- * @param[in]  keymap  The mapping between key symbol names and keycodes.
- * @param[out] wishes  The current collection of processed wishes.
+ * Handles the start of an element.
+ * @param[in] reader  The XML reader, positioned on the element.
+ *
+ * Wishes are collected for the <global> pseudo-application or for an
+ * <application> inside <applications>.  Anything else is skipped over.
+ *
+ * A numeric attribute that does not convert makes the whole document
+ * unusable:  none of its wishes are kept.
+ *
+ * @returns false if the document is not a wish document or is malformed, true
+ * otherwise.
  */
-static void
-process_ginn_node(xmlNodePtr node, Keymap* keymap, Wish::Table& wish_table)
+bool XmlWishReader::
+start_element(xmlTextReaderPtr reader)
 {
-  while (node)
+  int depth = xmlTextReaderDepth(reader);
+  if (depth == 0)
   {
-    if (node->type == XML_ELEMENT_NODE)
+    if (!is_element(reader, "ginn"))
     {
-      if (0 == strcmp((char const*)node->name, "global"))
+      std::cerr << source_name_ << ": unexpected document root '"
+                << xmlTextReaderConstLocalName(reader) << "'\n";
+      return false;
+    }
+  }
+  else
+  {
+    try
+    {
+      if (wish_)
       {
-        wish_table["<global>"] = process_application_node(node->children,
-                                                          keymap);
+        wish_->read_element(reader);
       }
-      else if (0 == strcmp((char const*)node->name, "applications"))
+      else if (app_depth_ >= 0)
       {
-        for (xmlNodePtr app_node = node->children;
-             app_node;
-             app_node = app_node->next)
+        if (depth == app_depth_ + 1 && is_element(reader, "wish"))
         {
-          if (app_node->type == XML_ELEMENT_NODE
-           && 0 == strcmp((char const*)app_node->name, "application"))
-          {
-            char const* name = (char const*)xmlGetProp(app_node, (xmlChar const*)"name");
-            wish_table[name] = process_application_node(app_node->children,
-                                                        keymap);
-          }
+          wish_.reset(new XmlWishBuilder(reader));
+          wish_depth_ = depth;
         }
       }
+      else if (depth == 1 && is_element(reader, "global"))
+      {
+        app_name_ = "<global>";
+        app_depth_ = depth;
+      }
+      else if (depth == 2 && is_element(reader, "application"))
+      {
+        app_name_.clear();
+        read_attribute(reader, "name", app_name_);
+        app_depth_ = depth;
+      }
+    }
+    catch (std::invalid_argument const&)
+    {
+      std::cerr << source_name_ << ": bad attribute\n";
+      return false;
+    }
+    catch (std::out_of_range const&)
+    {
+      std::cerr << source_name_ << ": bad attribute\n";
+      return false;
     }
-    node = node->next;
   }
+
+  if (xmlTextReaderIsEmptyElement(reader))
+    end_element(reader);
+  return true;
 }
 
 
-static Wish::Table
-load_wishes(ValidatorPtr const&          vctxt,
-            WishSource::RawSource const& raw_source,
-            Keymap*                      keymap)
+/**
+ * Handles the end of an element.
+ * @param[in] reader  The XML reader, positioned on the element.
+ *
+ * The end of a <wish> element completes a Wish, and the end of an application
+ * element completes that application's list of wishes.
+ */
+void XmlWishReader::
+end_element(xmlTextReaderPtr reader)
 {
-  Wish::Table wish_table;
+  int depth = xmlTextReaderDepth(reader);
+  if (wish_ && depth == wish_depth_)
+  {
+    auto wish = std::make_shared<Wish>(*wish_);
+    wish_list_[wish->name()] = wish;
+    wish_.reset();
+    wish_depth_ = -1;
+  }
+  else if (depth == app_depth_)
+  {
+    wish_table_[app_name_] = std::move(wish_list_);
+    wish_list_.clear();
+    app_depth_ = -1;
+  }
+}
+
 
-  XmlDocPtr xml_doc { xmlParseMemory(raw_source.source.data(),
-                                     raw_source.source.size()) };
-  if (!xml_doc)
+/**
+ * Reads the wishes from a raw source.
+ * @param[in] schema      The wish schema to validate against, if any.
+ * @param[in] raw_source  The raw source to read.
+ *
+ * The document is streamed through an xmlTextReader, validating it on the fly
+ * if wishes are being validated.  Nothing read from an invalid document is
+ * kept.
+ */
+static Wish::Table
+load_wishes(SchemaPtr const&             schema,
+            WishSource::RawSource const& raw_source)
+{
+  XmlReaderPtr reader { xmlReaderForMemory(raw_source.source.data(),
+                                           raw_source.source.size(),
+                                           raw_source.name.c_str(),
+                                           NULL, 0) };
+  if (!reader)
   {
     std::cerr << "error reading " << raw_source.name << "\n";
+    return Wish::Table();
   }
-  else
+
+  if (schema && 0 != xmlTextReaderRelaxNGSetSchema(reader.get(), schema.get()))
   {
-    if (vctxt)
-    {
-      int result = xmlRelaxNGValidateDoc(vctxt.get(), xml_doc.get());
-      if (result) {
-        std::cerr << "validation returned " << result << "\n";
-        return wish_table;
-      }
-    }
+    std::cerr << raw_source.name << ": unable to start validation\n";
+    return Wish::Table();
+  }
 
-    xmlNodePtr root = xmlDocGetRootElement(xml_doc.get());
-    if (root == NULL)
-    {
-      std::cerr << raw_source.name << ": empty document\n";
-    }
-    else if (0 != std::strcmp((char const*)root->name, "ginn"))
-    {
-      std::cerr << raw_source.name << ": unexpected document root '"
-                << root->name << "'\n";
-    }
-    else
+  XmlWishReader wish_reader(raw_source.name);
+  int result;
+  while ((result = xmlTextReaderRead(reader.get())) == 1)
+  {
+    switch (xmlTextReaderNodeType(reader.get()))
     {
-      process_ginn_node(root->children, keymap, wish_table);
+      case XML_READER_TYPE_ELEMENT:
+        if (!wish_reader.start_element(reader.get()))
+          return Wish::Table();
+        break;
+      case XML_READER_TYPE_END_ELEMENT:
+        wish_reader.end_element(reader.get());
+        break;
+      default:
+        break;
     }
   }
 
-  return wish_table;
+  if (result != 0)
+  {
+    std::cerr << "error reading " << raw_source.name << "\n";
+    return Wish::Table();
+  }
+  if (schema && xmlTextReaderIsValid(reader.get()) != 1)
+  {
+    std::cerr << raw_source.name << ": validation failed\n";
+    return Wish::Table();
+  }
+
+  return std::move(wish_reader.wish_table());
 }
 
 
 /**
- * Reads a wishes file and processes it into a Wish::List.
+ * Reads the wishes files and processes them into a Wish::Table.
  *
- * If configured, the wish file may be validated first.
+ * If configured, the wish files may be validated first.  The results are
+ * merged in the order of the raw sources so later files still override
+ * earlier ones.
  */
 Wish::Table XmlWishSource::
-get_wishes(WishSource::RawSourceList const& raw_wishes, Keymap* keymap)
+get_wishes(WishSource::RawSourceList const& raw_wishes)
 {
+  SourceWishes loaded = get_source_wishes(raw_wishes);
+
   Wish::Table wish_table;
-  for (auto const& raw_source: raw_wishes)
+  for (std::size_t i = 0; i < raw_wishes.size(); ++i)
   {
     if (impl_->config_->is_verbose_mode())
       std::cout << __FUNCTION__ << "(): "
-                << " loading '" << raw_source.name << "'\n";
-    impl_->wish_table_merge(wish_table,
-                            load_wishes(impl_->vctxt_, raw_source, keymap));
+                << " loaded '" << raw_wishes[i].name << "'\n";
+    impl_->wish_table_merge(wish_table, loaded[i]);
   }
   return wish_table;
 }
 
 
+/**
+ * Reads the wishes files and processes each into its own Wish::Table.
+ *
+ * The files are independent of each other, so they are parsed and validated
+ * by a pool of worker threads pulling the next unclaimed file until there are
+ * none left.  The parsed schema is read-only and shared, while each file gets
+ * its own streaming reader and validation context.  The results are kept in
+ * the order of the raw sources no matter which worker finished first.  A file
+ * that fails to load with an exception is reported by name and contributes no
+ * wishes, so one bad file does not cost the wishes of all the others.
+ */
+WishSource::SourceWishes XmlWishSource::
+get_source_wishes(WishSource::RawSourceList const& raw_wishes)
+{
+  SourceWishes loaded(raw_wishes.size());
+  std::vector<std::exception_ptr> failures(raw_wishes.size());
+  std::atomic<std::size_t> next_source(0);
+  auto load_sources = [this, &raw_wishes, &loaded, &failures, &next_source]()
+  {
+    for (std::size_t i = next_source++; i < raw_wishes.size(); i = next_source++)
+    {
+      try
+      {
+        loaded[i] = load_wishes(impl_->schema_, raw_wishes[i]);
+      }
+      catch (...)
+      {
+        failures[i] = std::current_exception();
+      }
+    }
+  };
+
+  std::size_t worker_count = std::min<std::size_t>(std::thread::hardware_concurrency(),
+                                                   raw_wishes.size());
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < worker_count; ++i)
+    workers.emplace_back(load_sources);
+  load_sources();
+  for (auto& worker: workers)
+    worker.join();
+
+  for (std::size_t i = 0; i < failures.size(); ++i)
+  {
+    if (!failures[i])
+      continue;
+    try
+    {
+      std::rethrow_exception(failures[i]);
+    }
+    catch (std::exception const& ex)
+    {
+      std::cerr << raw_wishes[i].name << ": " << ex.what() << "\n";
+    }
+    catch (...)
+    {
+      std::cerr << raw_wishes[i].name << ": unknown error\n";
+    }
+  }
+  return loaded;
+}
+
+
 } // namespace Ginn
 
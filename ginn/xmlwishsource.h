@@ -41,7 +41,10 @@ public:
   ~XmlWishSource();
 
   Wish::Table
-  get_wishes(RawSourceList const& raw_wishes, Keymap* keymap);
+  get_wishes(RawSourceList const& raw_wishes);
+
+  SourceWishes
+  get_source_wishes(RawSourceList const& raw_wishes);
 
 private:
   struct Impl;
@@ -20,44 +20,10 @@
  */
 #include "fakeapplicationsource.h"
 
-#include "ginn/applicationbuilder.h"
-
 
 namespace Ginn
 {
 
-class FakeApplicationBuilder
-: public ApplicationBuilder
-{
-public:
-  FakeApplicationBuilder(Application::Id const& id,
-                         std::string const&     name,
-                         std::string const&     generic_name)
-  : id_(id), name_(name), generic_name_(generic_name)
-  { }
-
-  ~FakeApplicationBuilder()
-  { }
-
-  virtual Application::Id
-  application_id() const
-  { return id_; }
-
-  virtual std::string
-  name() const
-  { return name_; }
-
-  virtual std::string
-  generic_name() const
-  { return generic_name_; }
-
-private:
-  Application::Id id_;
-  std::string     name_;
-  std::string     generic_name_;
-};
-
-
 FakeApplicationSource::
 FakeApplicationSource()
 : is_initialized_(false)
@@ -90,6 +56,13 @@ set_window_closed_callback(WindowClosedCallback const& callback)
 }
 
 
+void FakeApplicationSource::
+set_window_changed_callback(WindowChangedCallback const& callback)
+{
+  window_changed_callback_ = callback;
+}
+
+
 void FakeApplicationSource::
 add_application(Application::Id const& id,
                 std::string const&     name,
@@ -145,6 +118,22 @@ remove_window(Window::Id window_id)
 }
 
 
+void FakeApplicationSource::
+set_window_state(Window::Id window_id, bool is_active, bool is_visible)
+{
+  for (auto app: apps_)
+  {
+    if (Window* window = app.second->window(window_id))
+    {
+      window->is_active_ = is_active;
+      window->is_visible_ = is_visible;
+      if (window_changed_callback_)
+        window_changed_callback_(window);
+    }
+  }
+}
+
+
 void FakeApplicationSource::
 complete_initialization()
 {
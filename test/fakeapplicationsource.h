@@ -21,12 +21,49 @@
 #ifndef GINN_FAKEAPPLICATIONSOURCE_H_
 #define GINN_FAKEAPPLICATIONSOURCE_H_
 
+#include "ginn/applicationbuilder.h"
 #include "ginn/applicationsource.h"
+#include <string>
 
 
 namespace Ginn
 {
 
+/**
+ * Builds an application with the given id, name, and generic name.
+ */
+class FakeApplicationBuilder
+: public ApplicationBuilder
+{
+public:
+  FakeApplicationBuilder(Application::Id const& id,
+                         std::string const&     name,
+                         std::string const&     generic_name)
+  : id_(id), name_(name), generic_name_(generic_name)
+  { }
+
+  ~FakeApplicationBuilder()
+  { }
+
+  virtual Application::Id
+  application_id() const
+  { return id_; }
+
+  virtual std::string
+  name() const
+  { return name_; }
+
+  virtual std::string
+  generic_name() const
+  { return generic_name_; }
+
+private:
+  Application::Id id_;
+  std::string     name_;
+  std::string     generic_name_;
+};
+
+
 class FakeApplicationSource
 : public ApplicationSource
 {
@@ -43,6 +80,9 @@ public:
   virtual void
   set_window_closed_callback(WindowClosedCallback const& callback) override;
 
+  virtual void
+  set_window_changed_callback(WindowChangedCallback const& callback) override;
+
   void
   add_application(Application::Id const& id,
                   std::string const&     name,
@@ -55,6 +95,9 @@ public:
   void
   remove_window(Window::Id window_id);
 
+  void
+  set_window_state(Window::Id window_id, bool is_active, bool is_visible);
+
   void
   remove_application(Application::Id const& id);
 
@@ -69,6 +112,7 @@ private:
   InitializedCallback  initialized_callback_;
   WindowOpenedCallback window_opened_callback_;
   WindowClosedCallback window_closed_callback_;
+  WindowChangedCallback window_changed_callback_;
   Application::List    apps_;
 };
 
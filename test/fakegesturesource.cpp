@@ -20,12 +20,84 @@
  */
 #include "fakegesturesource.h"
 
+#include "ginn/property.h"
+
 
 namespace Ginn
 {
 
+FakeGestureEvent::
+FakeGestureEvent(GesturePhase phase)
+: phase_(phase)
+{ }
+
+
+FakeGestureEvent::
+~FakeGestureEvent()
+{ }
+
+
+void FakeGestureEvent::
+add_frame(Window::Id         window_id,
+          std::string const& gesture,
+          int                touches,
+          std::string const& property,
+          float              value,
+          GestureId          gesture_id)
+{
+  PropertySnapshot properties;
+  Property::Id id = Property::find(property);
+  if (id != Property::invalid_id)
+    properties.set(id, value);
+  frames_.push_back({ window_id, gesture, touches, gesture_id, properties });
+}
+
+
+GesturePhase FakeGestureEvent::
+phase() const
+{
+  return phase_;
+}
+
+
+std::size_t FakeGestureEvent::
+frame_count() const
+{
+  return frames_.size();
+}
+
+
+Window::Id FakeGestureEvent::
+window_id(std::size_t frame) const
+{
+  return frames_[frame].window_id;
+}
+
+
+bool FakeGestureEvent::
+is_gesture(std::size_t frame, std::string const& gesture, int touches) const
+{
+  return frames_[frame].gesture == gesture && frames_[frame].touches == touches;
+}
+
+
+GestureEvent::GestureId FakeGestureEvent::
+gesture_id(std::size_t frame) const
+{
+  return frames_[frame].gesture_id;
+}
+
+
+PropertySnapshot const& FakeGestureEvent::
+properties(std::size_t frame) const
+{
+  return frames_[frame].properties;
+}
+
+
 FakeGestureSource::
 FakeGestureSource()
+: live_subscriptions_(std::make_shared<std::size_t>(0))
 { }
 
 
@@ -48,10 +120,34 @@ set_event_callback(EventReceivedCallback const& event_callback)
 }
 
 
+namespace
+{
+
+/**
+ * A fake subscription that keeps count of the live subscriptions.
+ */
+class CountedGestureSubscription
+: public MockGestureSubscription
+{
+public:
+  CountedGestureSubscription(std::shared_ptr<std::size_t> const& live_count)
+  : live_count_(live_count)
+  { ++*live_count_; }
+
+  ~CountedGestureSubscription()
+  { --*live_count_; }
+
+private:
+  std::shared_ptr<std::size_t> live_count_;
+};
+
+} // anonymous namespace
+
+
 GestureSubscription::Ptr FakeGestureSource::
 subscribe(Window::Id, Wish::Ptr const&)
 {
-  GestureSubscription::Ptr p{ new MockGestureSubscription };
+  GestureSubscription::Ptr p{ new CountedGestureSubscription(live_subscriptions_) };
   return p;
 }
 
@@ -23,11 +23,71 @@
 
 #include "ginn/gesturesource.h"
 #include <gmock/gmock.h>
+#include <memory>
+#include <string>
+#include <vector>
 
 
 namespace Ginn
 {
 
+/**
+ * A fake gesture event built up one frame at a time.
+ */
+class FakeGestureEvent
+: public GestureEvent
+{
+public:
+  FakeGestureEvent(GesturePhase phase = GesturePhase::update);
+  ~FakeGestureEvent();
+
+  /**
+   * Adds a frame with a single property value.
+   *
+   * Like a real gesture event, only the value of a property already interned
+   * by a loaded wish is kept.
+   */
+  void
+  add_frame(Window::Id         window_id,
+            std::string const& gesture,
+            int                touches,
+            std::string const& property,
+            float              value,
+            GestureId          gesture_id = 1);
+
+  GesturePhase
+  phase() const;
+
+  std::size_t
+  frame_count() const;
+
+  Window::Id
+  window_id(std::size_t frame) const;
+
+  bool
+  is_gesture(std::size_t frame, std::string const& gesture, int touches) const;
+
+  GestureId
+  gesture_id(std::size_t frame) const;
+
+  PropertySnapshot const&
+  properties(std::size_t frame) const;
+
+private:
+  struct Frame
+  {
+    Window::Id        window_id;
+    std::string       gesture;
+    int               touches;
+    GestureId         gesture_id;
+    PropertySnapshot  properties;
+  };
+
+  GesturePhase       phase_;
+  std::vector<Frame> frames_;
+};
+
+
 /**
  * A fake subscription to gesture events.
  */
@@ -60,9 +120,15 @@ public:
   virtual GestureSubscription::Ptr
   subscribe(Window::Id window_id, Wish::Ptr const& wish);
 
+  /** Gets the number of subscriptions handed out and not yet destroyed. */
+  std::size_t
+  live_subscription_count() const
+  { return *live_subscriptions_; }
+
 protected:
   InitializedCallback   init_callback_;
   EventReceivedCallback event_callback_;
+  std::shared_ptr<std::size_t> live_subscriptions_;
 };
 
 } // namespace Ginn
@@ -39,11 +39,31 @@ set_initialized_callback(InitializedCallback const&)
 { }
 
 
+void FakeKeymap::
+set_changed_callback(ChangedCallback const& callback)
+{
+  changed_callback_ = callback;
+}
+
+
 Keymap::Keycode FakeKeymap::
-to_keycode(std::string const&) const
+to_keycode(Keysym keysym) const
 {
+  auto it = keycodes_.find(keysym);
+  if (it != keycodes_.end())
+    return it->second;
   return 0;
 }
 
+
+void FakeKeymap::
+map_key(Keysym keysym, Keycode keycode)
+{
+  bool is_remapped = keycodes_.count(keysym) > 0;
+  keycodes_[keysym] = keycode;
+  if (is_remapped && changed_callback_)
+    changed_callback_(KeysymList{keysym});
+}
+
 } // namespace Ginn
 
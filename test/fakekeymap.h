@@ -22,6 +22,7 @@
 #define GINN_FAKEKEYMAP_H_
 
 #include "ginn/keymap.h"
+#include <map>
 
 
 namespace Ginn
@@ -37,11 +38,24 @@ public:
   FakeKeymap();
   ~FakeKeymap();
 
+  using Keymap::to_keycode;
+
   void
   set_initialized_callback(InitializedCallback const& callback);
 
+  void
+  set_changed_callback(ChangedCallback const& callback);
+
   Keycode
-  to_keycode(std::string const& keysym_name) const;
+  to_keycode(Keysym keysym) const;
+
+  /** Maps a keysym to a keycode, reporting the change if it's a remapping. */
+  void
+  map_key(Keysym keysym, Keycode keycode);
+
+private:
+  std::map<Keysym, Keycode> keycodes_;
+  ChangedCallback           changed_callback_;
 };
 
 } // namespace Ginn
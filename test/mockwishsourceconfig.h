@@ -35,6 +35,7 @@ public:
   MOCK_CONST_METHOD0(wish_source_format, Format());
   MOCK_CONST_METHOD0(wish_sources, SourceNameList const&());
   MOCK_CONST_METHOD0(wish_schema_file_name, std::string const&());
+  MOCK_CONST_METHOD0(wish_bundle_file_name, std::string const&());
 };
 
 #endif // TEST_MOCK_WISHSOURCECONFIG_H_
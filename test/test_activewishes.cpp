@@ -18,18 +18,25 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include "fakeactionsink.h"
 #include "fakeapplicationsource.h"
 #include "fakegesturesource.h"
 #include "fakekeymap.h"
 #include <functional>
+#include "ginn/action.h"
 #include "ginn/activewishes.h"
 #include "ginn/configuration.h"
+#include "ginn/keysym.h"
 #include "ginn/wish.h"
 #include "ginn/wishsource.h"
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <memory>
+#include <string>
 #include "test/environment.h"
 
 using namespace Ginn;
+using ::testing::_;
 using Ginn::Test::Environment;
 using std::bind;
 using std::placeholders::_1;
@@ -53,6 +60,15 @@ static WishSource::RawSourceList one_wish_app = {
 };
 
 
+class MockActionSink
+: public FakeActionSink
+{
+public:
+  MOCK_METHOD1(perform, void(Action const& action));
+  MOCK_METHOD0(flush, void());
+};
+
+
 class ActiveWishesTest
 : public testing::Test
 {
@@ -81,7 +97,7 @@ public:
   void
   window_opened(Window const* window)
   {
-    active_wishes_.grant_wishes_for_window(wish_table_, window);
+    active_wishes_.grant_wishes_for_window(WishIndex(wish_table_), window);
   }
 
   void
@@ -103,6 +119,7 @@ protected:
   FakeGestureSource      gesture_source_;
   Wish::Table            wish_table_;
   ActiveWishes           active_wishes_;
+  testing::NiceMock<MockActionSink> action_sink_;
   int                    callback_count_;
 };
 
@@ -112,7 +129,7 @@ TEST_F(ActiveWishesTest, empty_wishes)
   WishSource::RawSourceList raws = {
     { "empty_wishes", "<ginn></ginn>" }
   };
-  wish_table_ = wish_source_->get_wishes(raws, &fake_keymap_);
+  wish_table_ = wish_source_->get_wishes(raws);
   app_source_.complete_initialization();
 
   EXPECT_EQ(callback_count_, 0);
@@ -121,7 +138,7 @@ TEST_F(ActiveWishesTest, empty_wishes)
 
 TEST_F(ActiveWishesTest, empty_applications)
 {
-  wish_table_ = wish_source_->get_wishes(one_wish_app, &fake_keymap_);
+  wish_table_ = wish_source_->get_wishes(one_wish_app);
   app_source_.complete_initialization();
 
   EXPECT_EQ(callback_count_, 0);
@@ -130,7 +147,7 @@ TEST_F(ActiveWishesTest, empty_applications)
 
 TEST_F(ActiveWishesTest, single_match_before_init)
 {
-  wish_table_ = wish_source_->get_wishes(one_wish_app, &fake_keymap_);
+  wish_table_ = wish_source_->get_wishes(one_wish_app);
 
   app_source_.add_application("test-app-id", "app-name", "generic_name");
   app_source_.add_window("test-app-id", 1000);
@@ -142,7 +159,7 @@ TEST_F(ActiveWishesTest, single_match_before_init)
 
 TEST_F(ActiveWishesTest, multiple_match_before_init)
 {
-  wish_table_ = wish_source_->get_wishes(one_wish_app, &fake_keymap_);
+  wish_table_ = wish_source_->get_wishes(one_wish_app);
 
   app_source_.add_application("test-app-id", "app-name", "dummy");
   app_source_.add_window("test-app-id", 0x1001);
@@ -155,7 +172,7 @@ TEST_F(ActiveWishesTest, multiple_match_before_init)
 
 TEST_F(ActiveWishesTest, single_match_after_init)
 {
-  wish_table_ = wish_source_->get_wishes(one_wish_app, &fake_keymap_);
+  wish_table_ = wish_source_->get_wishes(one_wish_app);
 
   app_source_.add_application("test-app-id", "app-name", "dummy");
   app_source_.complete_initialization();
@@ -167,7 +184,7 @@ TEST_F(ActiveWishesTest, single_match_after_init)
 
 TEST_F(ActiveWishesTest, remove_window)
 {
-  wish_table_ = wish_source_->get_wishes(one_wish_app, &fake_keymap_);
+  wish_table_ = wish_source_->get_wishes(one_wish_app);
   app_source_.add_application("test-app-id", "dummy", "dummy");
   app_source_.add_window("test-app-id", 0x1001);
   app_source_.add_window("test-app-id", 0x1002);
@@ -179,4 +196,463 @@ TEST_F(ActiveWishesTest, remove_window)
 }
 
 
+TEST_F(ActiveWishesTest, remove_window_after_reuse)
+{
+  wish_table_ = wish_source_->get_wishes(one_wish_app);
+  app_source_.add_application("test-app-id", "dummy", "dummy");
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.add_window("test-app-id", 0x1002);
+  app_source_.complete_initialization();
+  app_source_.remove_window(0x1001);
+  app_source_.add_window("test-app-id", 0x1003);
+  callback_count_ = 0;
+
+  app_source_.remove_window(0x1002);
+  EXPECT_EQ(callback_count_, 1);
+  app_source_.remove_window(0x1003);
+  EXPECT_EQ(callback_count_, 2);
+  app_source_.remove_window(0x1003);
+  EXPECT_EQ(callback_count_, 2);
+}
+
+
+TEST_F(ActiveWishesTest, regrant_changes_only_changed_wishes)
+{
+  WishSource::RawSourceList two_wishes = {
+    { "two_wishes",
+        "<ginn><applications><application name=\"test-app-id\">"
+          "<wish gesture=\"Pinch\" fingers=\"2\">"
+            "<action name=\"in\" when=\"update\">"
+              "<trigger prop=\"radius delta\" min=\"20\" max=\"80\"/>"
+              "<key>Up</key>"
+            "</action>"
+          "</wish>"
+          "<wish gesture=\"Pinch\" fingers=\"3\">"
+            "<action name=\"out\" when=\"update\">"
+              "<trigger prop=\"radius delta\" min=\"-80\" max=\"-20\"/>"
+              "<key>Down</key>"
+            "</action>"
+          "</wish>"
+        "</application></applications></ginn>" }
+  };
+  wish_table_ = wish_source_->get_wishes(two_wishes);
+  app_source_.add_application("test-app-id", "dummy", "dummy");
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.complete_initialization();
+  EXPECT_EQ(callback_count_, 2);
+
+  wish_table_ = wish_source_->get_wishes(two_wishes);
+  callback_count_ = 0;
+  app_source_.report_windows();
+  EXPECT_EQ(callback_count_, 0);
+
+  std::string text(two_wishes[0].source.data(), two_wishes[0].source.size());
+  text.replace(text.find("Down"), 4, "Left");
+  two_wishes[0].source = text;
+  wish_table_ = wish_source_->get_wishes(two_wishes);
+  app_source_.report_windows();
+  EXPECT_EQ(callback_count_, 2);
+}
+
+
+TEST_F(ActiveWishesTest, dispatch_to_window_in_frame)
+{
+  wish_table_ = wish_source_->get_wishes(one_wish_app);
+  app_source_.add_application("test-app-id", "dummy", "dummy");
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.add_window("test-app-id", 0x1002);
+  app_source_.complete_initialization();
+
+  FakeGestureEvent event;
+  event.add_frame(0x1002, "Pinch", 2, "radius delta", 50.0f);
+  event.add_frame(0x2000, "Pinch", 2, "radius delta", 50.0f);
+
+  EXPECT_CALL(action_sink_, perform(_)).Times(1);
+  active_wishes_.process_gesture_event(event, &action_sink_);
+}
+
+
+TEST_F(ActiveWishesTest, flush_once_per_event)
+{
+  wish_table_ = wish_source_->get_wishes(one_wish_app);
+  app_source_.add_application("test-app-id", "dummy", "dummy");
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.add_window("test-app-id", 0x1002);
+  app_source_.complete_initialization();
+
+  FakeGestureEvent event;
+  event.add_frame(0x1001, "Pinch", 2, "radius delta", 50.0f);
+  event.add_frame(0x1002, "Pinch", 2, "radius delta", 50.0f);
+  FakeGestureEvent miss;
+  miss.add_frame(0x2000, "Pinch", 2, "radius delta", 50.0f);
+
+  EXPECT_CALL(action_sink_, perform(_)).Times(2);
+  EXPECT_CALL(action_sink_, flush()).Times(1);
+  active_wishes_.process_gesture_event(event, &action_sink_);
+  active_wishes_.process_gesture_event(miss, &action_sink_);
+}
+
+
+TEST_F(ActiveWishesTest, dispatch_by_gesture_class_and_touches)
+{
+  wish_table_ = wish_source_->get_wishes(one_wish_app);
+  app_source_.add_application("test-app-id", "dummy", "dummy");
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.complete_initialization();
+
+  FakeGestureEvent event;
+  event.add_frame(0x1001, "Drag", 2, "radius delta", 50.0f);
+  event.add_frame(0x1001, "Pinch", 3, "radius delta", 50.0f);
+  event.add_frame(0x1001, "Pinch", 2, "radius delta", 100.0f);
+
+  EXPECT_CALL(action_sink_, perform(_)).Times(0);
+  active_wishes_.process_gesture_event(event, &action_sink_);
+}
+
+
+TEST_F(ActiveWishesTest, no_dispatch_after_revoke)
+{
+  wish_table_ = wish_source_->get_wishes(one_wish_app);
+  app_source_.add_application("test-app-id", "dummy", "dummy");
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.complete_initialization();
+  app_source_.remove_window(0x1001);
+
+  FakeGestureEvent event;
+  event.add_frame(0x1001, "Pinch", 2, "radius delta", 50.0f);
+
+  EXPECT_CALL(action_sink_, perform(_)).Times(0);
+  active_wishes_.process_gesture_event(event, &action_sink_);
+}
+
+
+TEST_F(ActiveWishesTest, dispatch_by_gesture_phase)
+{
+  WishSource::RawSourceList raws = {
+    { "finish_wish_app",
+        "<ginn>"
+          "<applications>"
+            "<application name=\"test-app-id\">"
+              "<wish gesture=\"Drag\" fingers=\"4\">"
+                "<action name=\"swipe\" when=\"finish\">"
+                  "<trigger prop=\"delta x\" min=\"40\" max=\"600\"/>"
+                  "<key modifier1=\"Control_L\">Left</key>"
+                "</action>"
+              "</wish>"
+            "</application>"
+          "</applications>"
+        "</ginn>" }
+  };
+  wish_table_ = wish_source_->get_wishes(raws);
+  app_source_.add_application("test-app-id", "dummy", "dummy");
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.complete_initialization();
+
+  FakeGestureEvent update_event(GesturePhase::update);
+  update_event.add_frame(0x1001, "Drag", 4, "delta x", 50.0f);
+  FakeGestureEvent end_event(GesturePhase::end);
+  end_event.add_frame(0x1001, "Drag", 4, "delta x", 50.0f);
+
+  EXPECT_CALL(action_sink_, perform(_)).Times(1);
+  active_wishes_.process_gesture_event(update_event, &action_sink_);
+  active_wishes_.process_gesture_event(update_event, &action_sink_);
+  active_wishes_.process_gesture_event(end_event, &action_sink_);
+}
+
+
+static WishSource::RawSourceList slow_drag_app(std::string const& mode)
+{
+  return {
+    { "slow_drag_app",
+        "<ginn>"
+          "<applications>"
+            "<application name=\"test-app-id\">"
+              "<wish gesture=\"Drag\" fingers=\"2\">"
+                "<action name=\"left\" when=\"update\">"
+                  "<trigger prop=\"delta x\" min=\"20\" max=\"80\" mode=\"" + mode + "\"/>"
+                  "<key>Left</key>"
+                "</action>"
+              "</wish>"
+            "</application>"
+          "</applications>"
+        "</ginn>" }
+  };
+}
+
+
+TEST_F(ActiveWishesTest, instantaneous_trigger)
+{
+  wish_table_ = wish_source_->get_wishes(slow_drag_app("instantaneous"));
+  app_source_.add_application("test-app-id", "dummy", "dummy");
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.complete_initialization();
+
+  FakeGestureEvent event;
+  event.add_frame(0x1001, "Drag", 2, "delta x", 8.0f);
+
+  EXPECT_CALL(action_sink_, perform(_)).Times(0);
+  for (int i = 0; i < 6; ++i)
+    active_wishes_.process_gesture_event(event, &action_sink_);
+}
+
+
+TEST_F(ActiveWishesTest, accumulated_trigger)
+{
+  wish_table_ = wish_source_->get_wishes(slow_drag_app("accumulated"));
+  app_source_.add_application("test-app-id", "dummy", "dummy");
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.complete_initialization();
+
+  FakeGestureEvent event;
+  event.add_frame(0x1001, "Drag", 2, "delta x", 8.0f);
+  FakeGestureEvent end_event(GesturePhase::end);
+  end_event.add_frame(0x1001, "Drag", 2, "delta x", 8.0f);
+
+  EXPECT_CALL(action_sink_, perform(_)).Times(2);
+  for (int i = 0; i < 6; ++i)
+    active_wishes_.process_gesture_event(event, &action_sink_);
+  active_wishes_.process_gesture_event(end_event, &action_sink_);
+  active_wishes_.process_gesture_event(event, &action_sink_);
+  active_wishes_.process_gesture_event(event, &action_sink_);
+}
+
+
+static WishSource::RawSourceList scroll_app(std::string const& policy)
+{
+  return {
+    { "scroll_app",
+        "<ginn>"
+          "<applications>"
+            "<application name=\"test-app-id\">"
+              "<wish gesture=\"Drag\" fingers=\"2\">"
+                "<action name=\"down\" when=\"update\">"
+                  "<trigger prop=\"delta y\" min=\"20\" max=\"80\" " + policy + "/>"
+                  "<button>5</button>"
+                "</action>"
+              "</wish>"
+            "</application>"
+          "</applications>"
+        "</ginn>" }
+  };
+}
+
+
+static FakeGestureEvent
+scroll_event(float delta_y, GesturePhase phase = GesturePhase::update)
+{
+  FakeGestureEvent event(phase);
+  event.add_frame(0x1001, "Drag", 2, "delta y", delta_y);
+  return event;
+}
+
+
+TEST_F(ActiveWishesTest, max_fires_per_gesture)
+{
+  wish_table_ = wish_source_->get_wishes(scroll_app("limit=\"2\""));
+  app_source_.add_application("test-app-id", "dummy", "dummy");
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.complete_initialization();
+
+  EXPECT_CALL(action_sink_, perform(_)).Times(3);
+  for (int i = 0; i < 5; ++i)
+    active_wishes_.process_gesture_event(scroll_event(30.0f), &action_sink_);
+  active_wishes_.process_gesture_event(scroll_event(0.0f, GesturePhase::end), &action_sink_);
+  active_wishes_.process_gesture_event(scroll_event(30.0f), &action_sink_);
+}
+
+
+TEST_F(ActiveWishesTest, concurrent_gestures_keep_separate_firing_state)
+{
+  wish_table_ = wish_source_->get_wishes(scroll_app("limit=\"1\""));
+  app_source_.add_application("test-app-id", "dummy", "dummy");
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.complete_initialization();
+
+  FakeGestureEvent first;
+  first.add_frame(0x1001, "Drag", 2, "delta y", 30.0f, 1);
+  FakeGestureEvent second;
+  second.add_frame(0x1001, "Drag", 2, "delta y", 30.0f, 2);
+
+  EXPECT_CALL(action_sink_, perform(_)).Times(2);
+  for (int i = 0; i < 3; ++i)
+  {
+    active_wishes_.process_gesture_event(first, &action_sink_);
+    active_wishes_.process_gesture_event(second, &action_sink_);
+  }
+}
+
+
+TEST_F(ActiveWishesTest, rearm_after_leaving_range)
+{
+  wish_table_ = wish_source_->get_wishes(scroll_app("rearm=\"5\""));
+  app_source_.add_application("test-app-id", "dummy", "dummy");
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.complete_initialization();
+
+  EXPECT_CALL(action_sink_, perform(_)).Times(2);
+  active_wishes_.process_gesture_event(scroll_event(30.0f), &action_sink_);
+  active_wishes_.process_gesture_event(scroll_event(30.0f), &action_sink_);
+  active_wishes_.process_gesture_event(scroll_event(17.0f), &action_sink_);
+  active_wishes_.process_gesture_event(scroll_event(30.0f), &action_sink_);
+  active_wishes_.process_gesture_event(scroll_event(10.0f), &action_sink_);
+  active_wishes_.process_gesture_event(scroll_event(30.0f), &action_sink_);
+}
+
+
+TEST_F(ActiveWishesTest, min_interval_between_fires)
+{
+  wish_table_ = wish_source_->get_wishes(scroll_app("interval=\"60000\""));
+  app_source_.add_application("test-app-id", "dummy", "dummy");
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.complete_initialization();
+
+  EXPECT_CALL(action_sink_, perform(_)).Times(1);
+  for (int i = 0; i < 3; ++i)
+    active_wishes_.process_gesture_event(scroll_event(30.0f), &action_sink_);
+}
+
+
+TEST_F(ActiveWishesTest, keymap_change_updates_keycodes)
+{
+  Keymap::Keysym left = keysym_from_name("Left");
+  fake_keymap_.map_key(left, 113);
+  wish_table_ = wish_source_->get_wishes(slow_drag_app("instantaneous"));
+  for (auto& wish: wish_table_["test-app-id"])
+    wish.second->resolve_keycodes(fake_keymap_);
+  fake_keymap_.set_changed_callback([this](Keymap::KeysymList const& changed)
+  {
+    for (auto& wish: wish_table_["test-app-id"])
+      wish.second->resolve_keycodes(fake_keymap_, changed);
+  });
+  Action const& action = wish_table_["test-app-id"].begin()->second->action();
+  ASSERT_EQ(std::begin(action)->code, 113);
+
+  fake_keymap_.map_key(left, 50);
+  EXPECT_EQ(std::begin(action)->code, 50);
+}
 
+
+/**
+ * Drives the active wishes of the one-wish application under the subscription
+ * policy given on the command line.
+ */
+class SubscriptionPolicyTest
+: public testing::Test
+{
+public:
+  void
+  start(char const* policy_option)
+  {
+    char arg0[] = "verify-ginn";
+    std::string arg1 = std::string("--subscriptions=") + policy_option;
+    char* argv[] = { arg0, &arg1[0], nullptr };
+    config_.reset(new Configuration(2, argv));
+    active_wishes_.reset(new ActiveWishes(*config_, &gesture_source_));
+    wish_index_ = WishIndex(WishSource::factory(config_.get())->get_wishes(one_wish_app));
+
+    app_source_.set_window_opened_callback([this](Window const* window)
+      { active_wishes_->grant_wishes_for_window(wish_index_, window); });
+    app_source_.set_window_closed_callback([this](Window const* window)
+      { active_wishes_->revoke_wishes_for_window(window); });
+    app_source_.set_window_changed_callback([this](Window const* window)
+      { active_wishes_->update_window(window); });
+
+    app_source_.add_application("test-app-id", "dummy", "dummy");
+    app_source_.add_application("other-app-id", "other", "other");
+    app_source_.complete_initialization();
+  }
+
+  /** Sends a root window pinch and checks how many actions it performs. */
+  void
+  expect_root_pinch_performs(int count)
+  {
+    FakeGestureEvent event;
+    event.add_frame(GestureSource::root_window, "Pinch", 2, "radius delta", 50.0f,
+                    ++gesture_id_);
+    EXPECT_CALL(action_sink_, perform(_)).Times(count);
+    active_wishes_->process_gesture_event(event, &action_sink_);
+    testing::Mock::VerifyAndClearExpectations(&action_sink_);
+  }
+
+protected:
+  std::unique_ptr<Configuration>     config_;
+  FakeGestureSource                  gesture_source_;
+  FakeApplicationSource              app_source_;
+  testing::NiceMock<MockActionSink>  action_sink_;
+  std::unique_ptr<ActiveWishes>      active_wishes_;
+  WishIndex                          wish_index_;
+  GestureEvent::GestureId            gesture_id_ = 0;
+};
+
+
+TEST_F(SubscriptionPolicyTest, lazy_subscriptions_follow_focus_and_visibility)
+{
+  start("lazy");
+  ASSERT_EQ(SubscriptionPolicy::lazy, config_->subscription_policy());
+
+  app_source_.add_window("test-app-id", 0x1001);
+  EXPECT_EQ(1u, gesture_source_.live_subscription_count());
+
+  app_source_.set_window_state(0x1001, false, false);
+  EXPECT_EQ(0u, gesture_source_.live_subscription_count());
+
+  app_source_.set_window_state(0x1001, true, false);
+  EXPECT_EQ(1u, gesture_source_.live_subscription_count());
+}
+
+
+TEST_F(SubscriptionPolicyTest, lazy_subscriptions_dropped_for_minimized_window)
+{
+  start("lazy");
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.add_window("other-app-id", 0x2001);
+  app_source_.set_window_state(0x1001, false, true);
+  EXPECT_EQ(1u, gesture_source_.live_subscription_count());
+
+  app_source_.set_window_state(0x1001, false, false);
+  EXPECT_EQ(0u, gesture_source_.live_subscription_count());
+
+  app_source_.set_window_state(0x1001, false, true);
+  EXPECT_EQ(1u, gesture_source_.live_subscription_count());
+}
+
+
+TEST_F(SubscriptionPolicyTest, root_subscriptions_dispatch_to_focused_application)
+{
+  start("root");
+  ASSERT_EQ(SubscriptionPolicy::root, config_->subscription_policy());
+
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.add_window("test-app-id", 0x1002);
+  app_source_.add_window("other-app-id", 0x2001);
+  EXPECT_EQ(1u, gesture_source_.live_subscription_count());
+  expect_root_pinch_performs(0);
+
+  app_source_.set_window_state(0x2001, false, true);
+  app_source_.set_window_state(0x1002, true, true);
+  expect_root_pinch_performs(1);
+
+  app_source_.remove_window(0x1001);
+  app_source_.remove_window(0x1002);
+  EXPECT_EQ(1u, gesture_source_.live_subscription_count());
+}
+
+
+TEST_F(SubscriptionPolicyTest, root_subscriptions_dispatch_nothing_without_focus)
+{
+  start("root");
+
+  app_source_.add_window("test-app-id", 0x1001);
+  app_source_.add_window("other-app-id", 0x2001);
+  app_source_.set_window_state(0x1001, true, true);
+  expect_root_pinch_performs(1);
+
+  app_source_.set_window_state(0x2001, true, true);
+  expect_root_pinch_performs(0);
+
+  app_source_.set_window_state(0x1001, true, true);
+  expect_root_pinch_performs(1);
+
+  app_source_.set_window_state(0x1001, false, true);
+  expect_root_pinch_performs(0);
+}
@@ -0,0 +1,96 @@
+/**
+ * @file test/test_applicationregistry.cpp
+ * @brief Unit tests of the application registry module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/applicationregistry.h"
+
+#include "fakeapplicationsource.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Ginn;
+
+
+namespace
+{
+
+std::unique_ptr<Application>
+new_application(Application::Id const& id)
+{
+  return std::unique_ptr<Application>(new Application(FakeApplicationBuilder(id, id, "")));
+}
+
+
+std::unique_ptr<Window>
+new_window(Window::Id id, Application const* app)
+{
+  return std::unique_ptr<Window>(new Window{ id, "A Window", app, true, true, 0 });
+}
+
+} // anonymous namespace
+
+
+TEST(ApplicationRegistry, finds_applications_and_windows)
+{
+  ApplicationRegistry registry;
+  Application* app = registry.add_application(new_application("terminal.desktop"));
+  EXPECT_EQ(app, registry.add_application(new_application("terminal.desktop")));
+  EXPECT_EQ(app, registry.application("terminal.desktop"));
+  EXPECT_EQ(nullptr, registry.application("gedit.desktop"));
+
+  Window const* window = registry.add_window(app, new_window(0x1001, app));
+  ASSERT_NE(nullptr, window);
+  EXPECT_EQ(nullptr, registry.add_window(app, new_window(0x1001, app)));
+  EXPECT_EQ(window, registry.window(0x1001));
+  EXPECT_EQ(app, registry.window(0x1001)->application_);
+}
+
+
+TEST(ApplicationRegistry, removes_windows)
+{
+  ApplicationRegistry registry;
+  Application* app = registry.add_application(new_application("terminal.desktop"));
+  registry.add_window(app, new_window(0x1001, app));
+  Window const* kept = registry.add_window(app, new_window(0x1002, app));
+
+  std::vector<Window::Id> closed;
+  auto on_closed = [&closed](Window const* w) { closed.push_back(w->id_); };
+  EXPECT_TRUE(registry.remove_window(0x1001, on_closed));
+  EXPECT_FALSE(registry.remove_window(0x1001, on_closed));
+  EXPECT_EQ(std::vector<Window::Id>{0x1001}, closed);
+  EXPECT_EQ(nullptr, registry.window(0x1001));
+  EXPECT_EQ(nullptr, app->window(0x1001));
+  EXPECT_EQ(kept, registry.window(0x1002));
+}
+
+
+TEST(ApplicationRegistry, removing_application_closes_its_windows)
+{
+  ApplicationRegistry registry;
+  Application* app = registry.add_application(new_application("terminal.desktop"));
+  registry.add_window(app, new_window(0x1001, app));
+  registry.add_window(app, new_window(0x1002, app));
+
+  int closed_count = 0;
+  EXPECT_TRUE(registry.remove_application("terminal.desktop",
+                                          [&closed_count](Window const*) { ++closed_count; }));
+  EXPECT_EQ(2, closed_count);
+  EXPECT_EQ(0u, registry.application_count());
+  EXPECT_EQ(0u, registry.window_count());
+}
@@ -0,0 +1,138 @@
+/**
+ * @file test/test_desktopentrycache.cpp
+ * @brief Unit tests of the desktop entry cache module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/desktopentrycache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+using namespace Ginn;
+
+
+class DesktopEntryCacheTest
+: public testing::Test
+{
+public:
+  DesktopEntryCacheTest()
+  : dir_name_("/tmp/ginn-test-apps-" + std::to_string(getpid()))
+  { }
+
+  void
+  SetUp()
+  {
+    mkdir(dir_name_.c_str(), 0700);
+    mkdir((dir_name_ + "/kde4").c_str(), 0700);
+    std::ofstream(dir_name_ + "/evince.desktop")
+      << "[Desktop Entry]\n"
+      << "Name=Document Viewer\n"
+      << "GenericName[de]=Dokumentenbetrachter\n"
+      << "GenericName = PDF Viewer\n"
+      << "[Desktop Action New]\n"
+      << "GenericName=Not This One\n";
+    std::ofstream(dir_name_ + "/kde4/okular.desktop")
+      << "# a comment\n"
+      << "[Desktop Entry]\n"
+      << "GenericName=Universal Document Viewer\n";
+    std::ofstream(dir_name_ + "/README") << "GenericName=Not A Desktop File\n";
+  }
+
+  void
+  TearDown()
+  {
+    std::remove((dir_name_ + "/kde4/okular.desktop").c_str());
+    std::remove((dir_name_ + "/kde4").c_str());
+    std::remove((dir_name_ + "/evince.desktop").c_str());
+    std::remove((dir_name_ + "/README").c_str());
+    std::remove(dir_name_.c_str());
+  }
+
+protected:
+  std::string dir_name_;
+};
+
+
+TEST_F(DesktopEntryCacheTest, scans_in_background)
+{
+  DesktopEntryCache cache("C");
+  bool scan_done = false;
+  cache.start_scan({dir_name_, dir_name_ + "/missing"}, [&scan_done]() { scan_done = true; });
+  cache.wait_for_scan();
+
+  EXPECT_TRUE(scan_done);
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_EQ("PDF Viewer", cache.generic_name(dir_name_ + "/evince.desktop"));
+  EXPECT_EQ("Universal Document Viewer", cache.generic_name(dir_name_ + "/kde4/okular.desktop"));
+}
+
+
+TEST_F(DesktopEntryCacheTest, reads_unscanned_file_in_background)
+{
+  DesktopEntryCache cache("C");
+  EXPECT_EQ("", cache.generic_name(dir_name_ + "/evince.desktop"));
+  EXPECT_EQ("", cache.generic_name(dir_name_ + "/missing.desktop"));
+  cache.wait_for_scan();
+
+  EXPECT_EQ("PDF Viewer", cache.generic_name(dir_name_ + "/evince.desktop"));
+  EXPECT_EQ("", cache.generic_name(dir_name_ + "/missing.desktop"));
+  EXPECT_EQ(2u, cache.size());
+}
+
+
+TEST_F(DesktopEntryCacheTest, prefers_best_localized_key)
+{
+  DesktopEntryCache german("de_DE.UTF-8@euro");
+  german.start_scan({dir_name_});
+  german.wait_for_scan();
+  EXPECT_EQ("Dokumentenbetrachter", german.generic_name(dir_name_ + "/evince.desktop"));
+
+  DesktopEntryCache french("fr_FR.UTF-8");
+  french.start_scan({dir_name_});
+  french.wait_for_scan();
+  EXPECT_EQ("PDF Viewer", french.generic_name(dir_name_ + "/evince.desktop"));
+}
+
+
+TEST_F(DesktopEntryCacheTest, rescan_rereads_changed_file)
+{
+  DesktopEntryCache cache("C");
+  int change_count = 0;
+  cache.start_scan({dir_name_}, [&change_count]() { ++change_count; });
+  cache.wait_for_scan();
+  std::string file_name = dir_name_ + "/kde4/okular.desktop";
+  EXPECT_EQ("Universal Document Viewer", cache.generic_name(file_name));
+  EXPECT_EQ(1, change_count);
+
+  std::ofstream(file_name)
+    << "[Desktop Entry]\n"
+    << "GenericName=Okular\n";
+  struct utimbuf times{1000, 1000};
+  utime(file_name.c_str(), &times);
+  EXPECT_EQ("Universal Document Viewer", cache.generic_name(file_name));
+
+  cache.rescan();
+  cache.wait_for_scan();
+  EXPECT_EQ("Okular", cache.generic_name(file_name));
+  EXPECT_EQ(2, change_count);
+}
@@ -0,0 +1,96 @@
+/**
+ * @file test/test_gestureaccumulator.cpp
+ * @brief Unit tests of the gesture accumulator module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/gestureaccumulator.h"
+
+#include "ginn/property.h"
+#include <gtest/gtest.h>
+
+using namespace Ginn;
+
+
+static PropertySnapshot
+snapshot_of(Property::Id id, float value)
+{
+  PropertySnapshot properties;
+  properties.set(id, value);
+  return properties;
+}
+
+
+TEST(GestureAccumulator, sums_frames_of_a_gesture)
+{
+  GestureAccumulator accumulator;
+  Property::Id delta_x = Property::intern("delta x");
+
+  accumulator.accumulate(7, snapshot_of(delta_x, 5.0f));
+  accumulator.accumulate(8, snapshot_of(delta_x, 100.0f));
+  GestureAccumulator::Gesture const& g = accumulator.accumulate(7, snapshot_of(delta_x, -2.0f));
+
+  EXPECT_EQ(g.gesture_id, 7);
+  EXPECT_FLOAT_EQ(g.sums[delta_x], 3.0f);
+}
+
+
+TEST(GestureAccumulator, release_resets_gesture)
+{
+  GestureAccumulator accumulator;
+  Property::Id delta_x = Property::intern("delta x");
+
+  std::uint32_t serial = accumulator.accumulate(7, snapshot_of(delta_x, 5.0f)).serial;
+  accumulator.release(7);
+  GestureAccumulator::Gesture const& g = accumulator.accumulate(7, snapshot_of(delta_x, 1.0f));
+
+  EXPECT_NE(g.serial, serial);
+  EXPECT_FLOAT_EQ(g.sums[delta_x], 1.0f);
+}
+
+
+TEST(GestureAccumulator, oldest_gesture_dropped_when_full)
+{
+  GestureAccumulator accumulator;
+  Property::Id delta_x = Property::intern("delta x");
+
+  for (int id = 0; id < static_cast<int>(GestureAccumulator::max_gestures); ++id)
+    accumulator.accumulate(id, snapshot_of(delta_x, 1.0f));
+  accumulator.accumulate(100, snapshot_of(delta_x, 1.0f));
+
+  EXPECT_FLOAT_EQ(accumulator.accumulate(1, snapshot_of(delta_x, 1.0f)).sums[delta_x], 2.0f);
+  EXPECT_FLOAT_EQ(accumulator.accumulate(100, snapshot_of(delta_x, 1.0f)).sums[delta_x], 2.0f);
+}
+
+
+TEST(GestureAccumulator, only_delta_properties_are_summed)
+{
+  GestureAccumulator accumulator;
+  Property::Id delta_y = Property::intern("delta y");
+  Property::Id position_x = Property::intern("position x");
+  ASSERT_TRUE(Property::is_delta(delta_y));
+  ASSERT_FALSE(Property::is_delta(position_x));
+
+  PropertySnapshot properties;
+  properties.set(delta_y, 2.0f);
+  properties.set(position_x, 300.0f);
+  accumulator.accumulate(7, properties);
+  GestureAccumulator::Gesture const& g = accumulator.accumulate(7, properties);
+
+  EXPECT_FLOAT_EQ(g.sums[delta_y], 4.0f);
+  EXPECT_FLOAT_EQ(g.sums[position_x], 0.0f);
+}
@@ -0,0 +1,61 @@
+/**
+ * @file test/test_initbarrier.cpp
+ * @brief Unit tests of the init barrier module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/initbarrier.h"
+
+#include <gtest/gtest.h>
+
+using namespace Ginn;
+
+
+TEST(InitBarrier, opens_when_last_component_arrives)
+{
+  int ready_count = 0;
+  InitBarrier barrier({"keymap", "wishes", "gestures"}, [&ready_count]() { ++ready_count; });
+  EXPECT_EQ(3u, barrier.pending());
+
+  barrier.arrive("wishes");
+  barrier.arrive("keymap");
+  EXPECT_FALSE(barrier.is_open());
+  EXPECT_EQ(0, ready_count);
+
+  barrier.arrive("gestures");
+  EXPECT_TRUE(barrier.is_open());
+  EXPECT_EQ(1, ready_count);
+}
+
+
+TEST(InitBarrier, ignores_repeat_and_unknown_arrivals)
+{
+  int ready_count = 0;
+  InitBarrier barrier({"keymap", "wishes"}, [&ready_count]() { ++ready_count; });
+
+  barrier.arrive("keymap");
+  barrier.arrive("keymap");
+  barrier.arrive("actions");
+  EXPECT_EQ(1u, barrier.pending());
+  EXPECT_EQ(0, ready_count);
+
+  barrier.arrive("wishes");
+  barrier.arrive("wishes");
+  EXPECT_EQ(1, ready_count);
+  for (auto const& component: barrier.components())
+    EXPECT_TRUE(component.arrived) << component.name;
+}
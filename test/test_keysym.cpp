@@ -0,0 +1,59 @@
+/**
+ * @file test/test_keysym.cpp
+ * @brief Unit tests of the Keysym module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/keysym.h"
+
+#include <gtest/gtest.h>
+
+using namespace Ginn;
+
+
+TEST(Keysym, names_used_in_wishes)
+{
+  EXPECT_EQ(keysym_from_name("Page_Up"),       0xff55u);
+  EXPECT_EQ(keysym_from_name("KP_Add"),        0xffabu);
+  EXPECT_EQ(keysym_from_name("Control_L"),     0xffe3u);
+  EXPECT_EQ(keysym_from_name("F10"),           0xffc7u);
+  EXPECT_EQ(keysym_from_name("W"),             0x0057u);
+  EXPECT_EQ(keysym_from_name("XF86AudioMute"), 0x1008ff12u);
+}
+
+
+TEST(Keysym, numeric_names)
+{
+  EXPECT_EQ(keysym_from_name("U20AC"),  0x010020acu);
+  EXPECT_EQ(keysym_from_name("U0041"),  0x0041u);
+  EXPECT_EQ(keysym_from_name("0xff55"), 0xff55u);
+}
+
+
+TEST(Keysym, unknown_names)
+{
+  EXPECT_EQ(keysym_from_name("NoSuchKey"), Keymap::no_symbol);
+  EXPECT_EQ(keysym_from_name(""),          Keymap::no_symbol);
+  EXPECT_EQ(keysym_from_name("Uxyz"),      Keymap::no_symbol);
+}
+
+
+TEST(Keysym, to_name)
+{
+  EXPECT_EQ(keysym_to_name(0xff55), "Page_Up");
+  EXPECT_EQ(keysym_to_name(0x0057), "W");
+}
@@ -0,0 +1,94 @@
+/**
+ * @file test/test_loadedsource.cpp
+ * @brief Unit tests of the loaded source module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/loadedsource.h"
+
+#include "ginn/wishbundle.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace Ginn;
+
+
+namespace
+{
+
+LoadedSource
+loaded(std::string const& name, std::string const& source, std::string const& app)
+{
+  Wish::Table wishes;
+  wishes[app];
+  return { name, fnv1a_hash(source.data(), source.size()), wishes };
+}
+
+} // anonymous namespace
+
+
+TEST(LoadedSource, unchanged_sources_need_no_reload)
+{
+  LoadedSourceList current = { loaded("a.xml", "<a/>", "app-a"),
+                               loaded("b.xml", "<b/>", "app-b") };
+  SourceDiff diff = diff_sources(current, { { "a.xml", "<a/>" }, { "b.xml", "<b/>" } });
+
+  EXPECT_TRUE(diff.is_unchanged());
+  ASSERT_EQ(2u, diff.sources.size());
+  EXPECT_EQ(1u, diff.sources[1].wishes.count("app-b"));
+}
+
+
+TEST(LoadedSource, only_changed_sources_are_parsed_again)
+{
+  LoadedSourceList current = { loaded("a.xml", "<a/>", "app-a"),
+                               loaded("b.xml", "<b/>", "app-b") };
+  SourceDiff diff = diff_sources(current, { { "a.xml", "<a/>" }, { "b.xml", "<b2/>" } });
+
+  EXPECT_FALSE(diff.is_unchanged());
+  EXPECT_TRUE(diff.same_sources);
+  ASSERT_EQ(1u, diff.changed_sources.size());
+  EXPECT_EQ("b.xml", diff.changed_sources[0].name);
+  ASSERT_EQ(1u, diff.changed_indexes.size());
+  EXPECT_EQ(1u, diff.changed_indexes[0]);
+  ASSERT_EQ(2u, diff.sources.size());
+  EXPECT_EQ(1u, diff.sources[0].wishes.count("app-a"));
+  EXPECT_TRUE(diff.sources[1].wishes.empty());
+}
+
+
+TEST(LoadedSource, added_and_removed_sources_are_changes)
+{
+  LoadedSourceList current = { loaded("a.xml", "<a/>", "app-a"),
+                               loaded("b.xml", "<b/>", "app-b") };
+
+  SourceDiff removed = diff_sources(current, { { "a.xml", "<a/>" } });
+  EXPECT_FALSE(removed.is_unchanged());
+  EXPECT_FALSE(removed.same_sources);
+  EXPECT_TRUE(removed.changed_sources.empty());
+  ASSERT_EQ(1u, removed.sources.size());
+  EXPECT_EQ(1u, removed.sources[0].wishes.count("app-a"));
+
+  SourceDiff added = diff_sources(current, { { "0.xml", "<a/>" },
+                                             { "a.xml", "<a/>" },
+                                             { "b.xml", "<b/>" } });
+  EXPECT_FALSE(added.is_unchanged());
+  EXPECT_FALSE(added.same_sources);
+  ASSERT_EQ(1u, added.changed_indexes.size());
+  EXPECT_EQ(0u, added.changed_indexes[0]);
+  EXPECT_EQ(1u, added.sources[2].wishes.count("app-b"));
+}
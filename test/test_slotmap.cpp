@@ -0,0 +1,55 @@
+/**
+ * @file test/test_slotmap.cpp
+ * @brief Unit tests of the SlotMap module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/slotmap.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace Ginn;
+
+
+TEST(SlotMap, insert_and_get)
+{
+  SlotMap<std::string> slot_map;
+  SlotHandle a = slot_map.insert("a");
+  SlotHandle b = slot_map.insert("b");
+
+  EXPECT_EQ(slot_map.size(), 2u);
+  ASSERT_NE(slot_map.get(a), nullptr);
+  EXPECT_EQ(*slot_map.get(a), "a");
+  EXPECT_EQ(*slot_map.get(b), "b");
+  EXPECT_EQ(slot_map.get(null_slot_handle), nullptr);
+}
+
+
+TEST(SlotMap, stale_handle_after_reuse)
+{
+  SlotMap<std::string> slot_map;
+  SlotHandle a = slot_map.insert("a");
+  EXPECT_TRUE(slot_map.erase(a));
+  EXPECT_FALSE(slot_map.erase(a));
+
+  SlotHandle b = slot_map.insert("b");
+  EXPECT_EQ(b.index, a.index);
+  EXPECT_EQ(slot_map.get(a), nullptr);
+  EXPECT_EQ(*slot_map.get(b), "b");
+  EXPECT_EQ(slot_map.size(), 1u);
+}
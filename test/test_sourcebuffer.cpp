@@ -0,0 +1,56 @@
+/**
+ * @file test/test_sourcebuffer.cpp
+ * @brief Unit tests of the source buffer module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/sourcebuffer.h"
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+
+using namespace Ginn;
+
+
+TEST(SourceBuffer, holds_a_string)
+{
+  SourceBuffer buffer("<ginn/>");
+  EXPECT_EQ(std::string(buffer.data(), buffer.size()), "<ginn/>");
+}
+
+
+TEST(SourceBuffer, maps_a_file)
+{
+  std::string file_name = "/tmp/ginn-test-" + std::to_string(getpid()) + ".xml";
+  std::ofstream(file_name) << "<ginn></ginn>";
+
+  SourceBuffer buffer;
+  ASSERT_TRUE(SourceBuffer::map_file(file_name, buffer));
+  SourceBuffer copy = buffer;
+  buffer = SourceBuffer();
+  EXPECT_EQ(std::string(copy.data(), copy.size()), "<ginn></ginn>");
+
+  std::ofstream(file_name, std::ios::trunc);
+  ASSERT_TRUE(SourceBuffer::map_file(file_name, buffer));
+  EXPECT_TRUE(buffer.empty());
+
+  std::remove(file_name.c_str());
+  EXPECT_FALSE(SourceBuffer::map_file(file_name, buffer));
+}
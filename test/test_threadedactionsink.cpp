@@ -0,0 +1,193 @@
+/**
+ * @file test/test_threadedactionsink.cpp
+ * @brief Unit tests of the threaded action sink.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/threadedactionsink.h"
+
+#include <condition_variable>
+#include "environment.h"
+#include "fakeactionsink.h"
+#include "ginn/action.h"
+#include "ginn/actionbuilder.h"
+#include <gtest/gtest.h>
+#include <mutex>
+#include <vector>
+
+using namespace Ginn;
+using Ginn::Test::Environment;
+
+namespace
+{
+
+/**
+ * Builds a single key press action.
+ */
+class KeyPressBuilder
+: public ActionBuilder
+{
+public:
+  KeyPressBuilder(Keymap::Keycode code)
+  : events_{ { Action::EventType::key_press, code, Keymap::no_symbol } }
+  { }
+
+  Action::EventList const&
+  events() const
+  { return events_; }
+
+private:
+  Action::EventList events_;
+};
+
+
+Action
+key_press(Keymap::Keycode code)
+{ return Action(KeyPressBuilder(code)); }
+
+
+/**
+ * Records the keycodes of the actions performed, optionally holding up the
+ * first one until released.
+ */
+class RecordingActionSink
+: public FakeActionSink
+{
+public:
+  RecordingActionSink(bool gated = false)
+  : gated_(gated)
+  , entered_(false)
+  { }
+
+  void
+  perform(Action const& action)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    codes_.push_back(std::begin(action)->code);
+    if (gated_)
+    {
+      entered_ = true;
+      changed_.notify_all();
+      changed_.wait(lock, [this]() { return !gated_; });
+    }
+  }
+
+  void
+  wait_until_held()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this]() { return entered_; });
+  }
+
+  void
+  release()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    gated_ = false;
+    changed_.notify_all();
+  }
+
+  std::vector<Keymap::Keycode>
+  codes()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return codes_;
+  }
+
+private:
+  std::mutex                   mutex_;
+  std::condition_variable      changed_;
+  bool                         gated_;
+  bool                         entered_;
+  std::vector<Keymap::Keycode> codes_;
+};
+
+} // anonymous namespace
+
+
+TEST(ThreadedActionSink, performs_in_order)
+{
+  RecordingActionSink sink;
+  {
+    ThreadedActionSink threaded_sink(Environment::config(), &sink,
+                                     ActionQueuePolicy::drop_oldest, 4);
+    threaded_sink.perform(key_press(1));
+    threaded_sink.perform(key_press(2));
+    threaded_sink.perform(key_press(3));
+    threaded_sink.flush();
+  }
+  EXPECT_EQ(sink.codes(), (std::vector<Keymap::Keycode>{1, 2, 3}));
+}
+
+
+TEST(ThreadedActionSink, drop_oldest_when_full)
+{
+  RecordingActionSink sink(true);
+  {
+    ThreadedActionSink threaded_sink(Environment::config(), &sink,
+                                     ActionQueuePolicy::drop_oldest, 4);
+    threaded_sink.perform(key_press(10));
+    threaded_sink.flush();
+    sink.wait_until_held();
+
+    for (Keymap::Keycode code = 1; code <= 6; ++code)
+      threaded_sink.perform(key_press(code));
+    EXPECT_EQ(threaded_sink.dropped_count(), 2u);
+    sink.release();
+  }
+  EXPECT_EQ(sink.codes(), (std::vector<Keymap::Keycode>{10, 3, 4, 5, 6}));
+}
+
+
+TEST(ThreadedActionSink, coalesce_repeats_when_full)
+{
+  RecordingActionSink sink(true);
+  {
+    ThreadedActionSink threaded_sink(Environment::config(), &sink,
+                                     ActionQueuePolicy::coalesce, 4);
+    threaded_sink.perform(key_press(10));
+    threaded_sink.flush();
+    sink.wait_until_held();
+
+    for (Keymap::Keycode code = 1; code <= 4; ++code)
+      threaded_sink.perform(key_press(code));
+    threaded_sink.perform(key_press(4));
+    threaded_sink.perform(key_press(5));
+    EXPECT_EQ(threaded_sink.dropped_count(), 2u);
+    sink.release();
+  }
+  EXPECT_EQ(sink.codes(), (std::vector<Keymap::Keycode>{10, 2, 3, 4, 5}));
+}
+
+
+TEST(ThreadedActionSink, block_when_full)
+{
+  RecordingActionSink sink;
+  std::vector<Keymap::Keycode> expected;
+  {
+    ThreadedActionSink threaded_sink(Environment::config(), &sink,
+                                     ActionQueuePolicy::block, 2);
+    for (Keymap::Keycode code = 1; code <= 20; ++code)
+    {
+      threaded_sink.perform(key_press(code));
+      expected.push_back(code);
+    }
+    threaded_sink.flush();
+    EXPECT_EQ(threaded_sink.dropped_count(), 0u);
+  }
+  EXPECT_EQ(sink.codes(), expected);
+}
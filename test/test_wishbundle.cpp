@@ -0,0 +1,155 @@
+/**
+ * @file test/test_wishbundle.cpp
+ * @brief Unit tests of the wish bundle module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/wishbundle.h"
+
+#include <cstdio>
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+#include "test/mockwishsourceconfig.h"
+#include <unistd.h>
+
+using namespace ::testing;
+
+
+class WishBundleTest
+: public testing::Test
+{
+public:
+  WishBundleTest()
+  : bundle_file_name_("/tmp/ginn-test-" + std::to_string(getpid()) + ".bundle")
+  , raws_({
+    { "one.xml",
+      "<ginn>"
+        "<global>"
+          "<wish gesture=\"Drag\" fingers=\"2\">"
+            "<action name=\"scroll\" when=\"update\">"
+              "<trigger prop=\"delta y\" min=\"5\" max=\"100\" mode=\"accumulated\""
+                      " interval=\"16\" rearm=\"2\" limit=\"3\"/>"
+              "<button>5</button>"
+            "</action>"
+          "</wish>"
+        "</global>"
+      "</ginn>" },
+    { "two.xml",
+      "<ginn>"
+        "<applications>"
+          "<application name=\"dummy\">"
+            "<wish gesture=\"Pinch\" fingers=\"2\">"
+              "<action name=\"zoom\" when=\"finish\">"
+                "<trigger prop=\"radius delta\" min=\"20\" max=\"80\"/>"
+                "<key modifier1=\"Control_L\">Up</key>"
+              "</action>"
+            "</wish>"
+          "</application>"
+        "</applications>"
+      "</ginn>" } })
+  {
+    ON_CALL(config_, wish_source_format()).WillByDefault(Return(Ginn::WishSourceConfig::Format::XML));
+    ON_CALL(config_, wish_schema_file_name()).WillByDefault(ReturnRef(Ginn::WishSourceConfig::WISH_NO_VALIDATE));
+    ON_CALL(config_, wish_bundle_file_name()).WillByDefault(ReturnRef(bundle_file_name_));
+    source_wishes_ = Ginn::WishSource::format_factory(&config_)->get_source_wishes(raws_);
+    wish_table_ = Ginn::WishSource::merge_wishes(source_wishes_);
+  }
+
+  ~WishBundleTest()
+  { std::remove(bundle_file_name_.c_str()); }
+
+protected:
+  NiceMock<MockWishSourceConfig>  config_;
+  std::string                     bundle_file_name_;
+  Ginn::WishSource::RawSourceList raws_;
+  Ginn::WishSource::SourceWishes  source_wishes_;
+  Ginn::Wish::Table               wish_table_;
+};
+
+
+TEST_F(WishBundleTest, round_trip)
+{
+  ASSERT_TRUE(Ginn::WishBundle::write(bundle_file_name_, raws_, source_wishes_));
+
+  Ginn::WishBundle bundle(bundle_file_name_);
+  ASSERT_TRUE(bundle.is_valid());
+  EXPECT_TRUE(bundle.is_current_for(raws_));
+
+  Ginn::Wish::Table loaded = bundle.wishes();
+  ASSERT_EQ(wish_table_.size(), loaded.size());
+  for (auto const& app: wish_table_)
+  {
+    Ginn::Wish::List const& loaded_list = loaded[app.first];
+    ASSERT_EQ(app.second.size(), loaded_list.size()) << app.first;
+    for (auto const& entry: app.second)
+    {
+      auto it = loaded_list.find(entry.first);
+      ASSERT_NE(it, loaded_list.end()) << entry.first;
+      Ginn::Wish const& expected = *entry.second;
+      Ginn::Wish const& actual = *it->second;
+      EXPECT_EQ(expected.gesture(), actual.gesture());
+      EXPECT_EQ(expected.touches(), actual.touches());
+      EXPECT_EQ(expected.when(), actual.when());
+      EXPECT_EQ(expected.property_id(), actual.property_id());
+      EXPECT_EQ(expected.min(), actual.min());
+      EXPECT_EQ(expected.max(), actual.max());
+      EXPECT_EQ(expected.trigger_mode(), actual.trigger_mode());
+      EXPECT_EQ(expected.min_interval(), actual.min_interval());
+      EXPECT_EQ(expected.rearm_margin(), actual.rearm_margin());
+      EXPECT_EQ(expected.max_fires(), actual.max_fires());
+      EXPECT_EQ(expected.action(), actual.action());
+    }
+  }
+}
+
+
+TEST_F(WishBundleTest, stale_when_sources_change)
+{
+  ASSERT_TRUE(Ginn::WishBundle::write(bundle_file_name_, raws_, source_wishes_));
+  Ginn::WishBundle bundle(bundle_file_name_);
+
+  std::string text(raws_[1].source.data(), raws_[1].source.size());
+  text[text.find("80")] = '9';
+  Ginn::WishSource::RawSourceList edited = { raws_[0], { raws_[1].name, text } };
+  EXPECT_FALSE(bundle.is_current_for(edited));
+
+  Ginn::WishSource::RawSourceList reordered = { raws_[1], raws_[0] };
+  EXPECT_FALSE(bundle.is_current_for(reordered));
+
+  Ginn::WishSource::RawSourceList fewer = { raws_[0] };
+  EXPECT_FALSE(bundle.is_current_for(fewer));
+}
+
+
+TEST_F(WishBundleTest, rejects_damaged_bundle)
+{
+  ASSERT_TRUE(Ginn::WishBundle::write(bundle_file_name_, raws_, source_wishes_));
+  ASSERT_EQ(0, truncate(bundle_file_name_.c_str(), 64));
+
+  Ginn::WishBundle bundle(bundle_file_name_);
+  EXPECT_FALSE(bundle.is_valid());
+  EXPECT_FALSE(bundle.is_current_for(raws_));
+  EXPECT_TRUE(bundle.wishes().empty());
+}
+
+
+TEST_F(WishBundleTest, missing_bundle_falls_back_to_raw_sources)
+{
+  Ginn::WishSource::Ptr source = Ginn::WishSource::factory(&config_);
+  Ginn::Wish::Table loaded = source->get_wishes(raws_);
+  EXPECT_EQ(wish_table_.size(), loaded.size());
+}
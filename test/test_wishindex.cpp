@@ -0,0 +1,123 @@
+/**
+ * @file test/test_wishindex.cpp
+ * @brief Unit tests of the wish index module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/wishindex.h"
+
+#include "fakeapplicationsource.h"
+#include "ginn/application.h"
+#include "ginn/wishsource.h"
+#include <gtest/gtest.h>
+#include "test/environment.h"
+
+using namespace Ginn;
+using Ginn::Test::Environment;
+
+
+namespace
+{
+
+WishSource::RawSourceList app_and_global_wishes = {
+  { "app_and_global_wishes",
+      "<ginn>"
+        "<global>"
+          "<wish gesture=\"Drag\" fingers=\"3\">"
+            "<action name=\"switch\" when=\"finish\">"
+              "<trigger prop=\"delta x\" min=\"100\" max=\"1000\"/>"
+              "<key modifier1=\"Alt_L\">Tab</key>"
+            "</action>"
+          "</wish>"
+          "<wish gesture=\"Tap\" fingers=\"4\">"
+            "<action name=\"zoom\" when=\"finish\">"
+              "<trigger prop=\"tap time\" min=\"0\" max=\"300\"/>"
+              "<key>F11</key>"
+            "</action>"
+          "</wish>"
+        "</global>"
+        "<applications>"
+          "<application name=\"evince\">"
+            "<wish gesture=\"Drag\" fingers=\"3\">"
+              "<action name=\"next page\" when=\"finish\">"
+                "<trigger prop=\"delta x\" min=\"200\" max=\"1000\"/>"
+                "<key>Next</key>"
+              "</action>"
+            "</wish>"
+          "</application>"
+          "<application name=\"Terminal\">"
+            "<wish gesture=\"Pinch\" fingers=\"2\">"
+              "<action name=\"bigger\" when=\"update\">"
+                "<trigger prop=\"radius delta\" min=\"20\" max=\"80\"/>"
+                "<key modifier1=\"Control_L\">plus</key>"
+              "</action>"
+            "</wish>"
+          "</application>"
+        "</applications>"
+      "</ginn>" }
+};
+
+} // anonymous namespace
+
+
+class WishIndexTest
+: public testing::Test
+{
+public:
+  WishIndexTest()
+  : wish_source_(WishSource::factory(&Environment::config()))
+  , index_(wish_source_->get_wishes(app_and_global_wishes))
+  { }
+
+protected:
+  WishSource::Ptr wish_source_;
+  WishIndex       index_;
+};
+
+
+TEST_F(WishIndexTest, matches_desktop_file_base_name)
+{
+  Application app(FakeApplicationBuilder("/usr/share/applications/evince.desktop",
+                                         "Document Viewer", "PDF Viewer"));
+  WishIndex::WishList const& wishes = index_.wishes_for(app);
+  ASSERT_EQ(2u, wishes.size());
+  ASSERT_TRUE(WishIndex::find(wishes, "Drag3delta x") != nullptr);
+  EXPECT_EQ(200.0f, WishIndex::find(wishes, "Drag3delta x")->min());
+  EXPECT_TRUE(WishIndex::find(wishes, "Tap4tap time") != nullptr);
+}
+
+
+TEST_F(WishIndexTest, matches_generic_name)
+{
+  Application app(FakeApplicationBuilder("/usr/share/applications/gnome-terminal.desktop",
+                                         "GNOME Terminal", "Terminal"));
+  WishIndex::WishList const& wishes = index_.wishes_for(app);
+  EXPECT_EQ(3u, wishes.size());
+  EXPECT_TRUE(WishIndex::find(wishes, "Pinch2radius delta") != nullptr);
+}
+
+
+TEST_F(WishIndexTest, unmatched_application_gets_global_wishes)
+{
+  Application app(FakeApplicationBuilder("/usr/share/applications/gedit.desktop",
+                                         "gedit", "Text Editor"));
+  WishIndex::WishList const& wishes = index_.wishes_for(app);
+  ASSERT_EQ(2u, wishes.size());
+  ASSERT_TRUE(WishIndex::find(wishes, "Drag3delta x") != nullptr);
+  EXPECT_EQ(100.0f, WishIndex::find(wishes, "Drag3delta x")->min());
+  EXPECT_TRUE(WishIndex::find(wishes, "Pinch2radius delta") == nullptr);
+}
@@ -0,0 +1,47 @@
+/**
+ * @file test/test_x11windowstate.cpp
+ * @brief Unit tests of the X11WindowState module.
+ */
+
+/*
+ * Copyright 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ginn/x11windowstate.h"
+
+#include <gtest/gtest.h>
+
+using namespace Ginn;
+
+
+TEST(X11WindowState, minimized_window_is_off_screen)
+{
+  EXPECT_TRUE(X11WindowState::is_on_screen(false, 1, 1));
+  EXPECT_FALSE(X11WindowState::is_on_screen(true, 1, 1));
+  EXPECT_FALSE(X11WindowState::is_on_screen(true, X11WindowState::all_desktops, 1));
+}
+
+
+TEST(X11WindowState, window_on_other_workspace_is_off_screen)
+{
+  EXPECT_FALSE(X11WindowState::is_on_screen(false, 0, 1));
+  EXPECT_TRUE(X11WindowState::is_on_screen(false, X11WindowState::all_desktops, 1));
+}
+
+
+TEST(X11WindowState, workspace_ignored_when_current_one_unknown)
+{
+  EXPECT_TRUE(X11WindowState::is_on_screen(false, 0, X11WindowState::all_desktops));
+  EXPECT_FALSE(X11WindowState::is_on_screen(true, 0, X11WindowState::all_desktops));
+}
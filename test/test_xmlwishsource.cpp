@@ -19,6 +19,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "fakekeymap.h"
+#include "ginn/property.h"
 #include "ginn/wishsource.h"
 #include "gmock/gmock.h"
 #include <gtest/gtest.h>
@@ -32,7 +33,7 @@ class MockKeymap
 : public Ginn::FakeKeymap
 {
 public:
-  MOCK_CONST_METHOD1(to_keycode, Keymap::Keycode(std::string const& keysym_name));
+  MOCK_CONST_METHOD1(to_keycode, Keymap::Keycode(Keymap::Keysym keysym));
 };
 
 
@@ -45,6 +46,7 @@ public:
   {
     EXPECT_CALL(config_, wish_source_format()).WillOnce(Return(Ginn::WishSourceConfig::Format::XML));
     EXPECT_CALL(config_, wish_schema_file_name()).WillOnce(ReturnRef(Ginn::WishSourceConfig::WISH_NO_VALIDATE));
+    ON_CALL(config_, wish_bundle_file_name()).WillByDefault(ReturnRef(no_bundle_));
   }
 
   virtual void
@@ -56,6 +58,7 @@ public:
 
 protected:
   NiceMock<MockWishSourceConfig>  config_;
+  std::string                     no_bundle_;
   Ginn::WishSource::Ptr           source_;
   MockKeymap                      keymap_;
 };
@@ -67,7 +70,7 @@ TEST_F(TestXMLWishSource, invalidXML)
     { "invalid xml", "invalid xml" }
   };
 
-  Ginn::Wish::Table table = source_->get_wishes(raws, &keymap_);
+  Ginn::Wish::Table table = source_->get_wishes(raws);
   ASSERT_TRUE(table.size() == 0);
 }
 
@@ -90,10 +93,182 @@ TEST_F(TestXMLWishSource, basic)
       "</ginn>" }
   };
 
-  EXPECT_CALL(keymap_, to_keycode(_)).Times(AtLeast(2));
-  Ginn::Wish::Table table = source_->get_wishes(raws, &keymap_);
+  EXPECT_CALL(keymap_, to_keycode(_)).Times(0);
+  Ginn::Wish::Table table = source_->get_wishes(raws);
   ASSERT_TRUE(table.size() == 1);
+  testing::Mock::VerifyAndClearExpectations(&keymap_);
+
+  EXPECT_CALL(keymap_, to_keycode(_)).Times(AtLeast(2));
+  for (auto const& wish: table["dummy"])
+    wish.second->resolve_keycodes(keymap_);
+}
+
+
+TEST_F(TestXMLWishSource, trigger_property_is_interned)
+{
+  Ginn::WishSource::RawSourceList raws = {
+    { "interned",
+      "<ginn>"
+        "<applications>"
+          "<application name=\"dummy\">"
+            "<wish gesture=\"Drag\" fingers=\"2\">"
+              "<action name=\"left\" when=\"update\">"
+                "<trigger prop=\"delta x\" min=\"20\" max=\"80\"/>"
+                "<key>Left</key>"
+              "</action>"
+            "</wish>"
+            "<wish gesture=\"Drag\" fingers=\"3\">"
+              "<action name=\"right\" when=\"update\">"
+                "<trigger prop=\"delta x\" min=\"-80\" max=\"-20\"/>"
+                "<key>Right</key>"
+              "</action>"
+            "</wish>"
+          "</application>"
+        "</applications>"
+      "</ginn>" }
+  };
+
+  Ginn::Wish::Table table = source_->get_wishes(raws);
+  ASSERT_EQ(table["dummy"].size(), 2u);
+
+  Ginn::Property::Id id = Ginn::Property::intern("delta x");
+  EXPECT_EQ(Ginn::Property::name(id), "delta x");
+  for (auto const& wish: table["dummy"])
+    EXPECT_EQ(wish.second->property_id(), id);
+}
+
+
+TEST_F(TestXMLWishSource, later_sources_override_earlier_ones)
+{
+  Ginn::WishSource::RawSourceList raws;
+  for (int i = 0; i < 64; ++i)
+  {
+    raws.push_back({ "source" + std::to_string(i),
+      "<ginn>"
+        "<applications>"
+          "<application name=\"app" + std::to_string(i % 4) + "\">"
+            "<wish gesture=\"Drag\" fingers=\"" + std::to_string(i) + "\">"
+              "<action name=\"left\" when=\"update\">"
+                "<trigger prop=\"delta x\" min=\"20\" max=\"80\"/>"
+                "<key>Left</key>"
+              "</action>"
+            "</wish>"
+          "</application>"
+        "</applications>"
+      "</ginn>" });
+  }
+
+  Ginn::Wish::Table table = source_->get_wishes(raws);
+  ASSERT_EQ(table.size(), 4u);
+  for (int app = 0; app < 4; ++app)
+  {
+    Ginn::Wish::List const& wishes = table["app" + std::to_string(app)];
+    ASSERT_EQ(wishes.size(), 1u);
+    EXPECT_EQ(wishes.begin()->second->touches(), 60 + app);
+  }
+}
+
+
+TEST_F(TestXMLWishSource, bad_numeric_attribute_is_rejected)
+{
+  Ginn::WishSource::RawSourceList raws = {
+    { "bad number",
+      "<ginn>"
+        "<applications>"
+          "<application name=\"dummy\">"
+            "<wish gesture=\"Drag\" fingers=\"2\">"
+              "<action name=\"left\" when=\"update\">"
+                "<trigger prop=\"delta x\" min=\"abc\" max=\"80\"/>"
+                "<key>Left</key>"
+              "</action>"
+            "</wish>"
+          "</application>"
+        "</applications>"
+      "</ginn>" }
+  };
+
+  Ginn::Wish::Table table = source_->get_wishes(raws);
+  EXPECT_EQ(table.size(), 0u);
 }
 
 
+TEST_F(TestXMLWishSource, bad_document_is_rejected_whole)
+{
+  Ginn::WishSource::RawSourceList raws = {
+    { "good",
+      "<ginn>"
+        "<applications>"
+          "<application name=\"good\">"
+            "<wish gesture=\"Drag\" fingers=\"2\">"
+              "<action name=\"left\" when=\"update\">"
+                "<trigger prop=\"delta x\" min=\"20\" max=\"80\"/>"
+                "<key>Left</key>"
+              "</action>"
+            "</wish>"
+          "</application>"
+        "</applications>"
+      "</ginn>" },
+    { "partly bad",
+      "<ginn>"
+        "<applications>"
+          "<application name=\"valid\">"
+            "<wish gesture=\"Drag\" fingers=\"2\">"
+              "<action name=\"left\" when=\"update\">"
+                "<trigger prop=\"delta x\" min=\"20\" max=\"80\"/>"
+                "<key>Left</key>"
+              "</action>"
+            "</wish>"
+          "</application>"
+          "<application name=\"invalid\">"
+            "<wish gesture=\"Drag\" fingers=\"99999999999\">"
+              "<action name=\"left\" when=\"update\">"
+                "<trigger prop=\"delta x\" min=\"20\" max=\"80\"/>"
+                "<button>one</button>"
+              "</action>"
+            "</wish>"
+          "</application>"
+        "</applications>"
+      "</ginn>" }
+  };
+
+  Ginn::Wish::Table table = source_->get_wishes(raws);
+  ASSERT_EQ(table.size(), 1u);
+  EXPECT_EQ(table.count("good"), 1u);
+  EXPECT_EQ(table.count("valid"), 0u);
+}
+
+
+TEST_F(TestXMLWishSource, accumulated_mode_needs_a_delta_property)
+{
+  Ginn::WishSource::RawSourceList raws = {
+    { "accumulated",
+      "<ginn>"
+        "<applications>"
+          "<application name=\"dummy\">"
+            "<wish gesture=\"Drag\" fingers=\"2\">"
+              "<action name=\"slide\" when=\"update\">"
+                "<trigger prop=\"delta x\" min=\"20\" max=\"80\" mode=\"accumulated\"/>"
+                "<key>Left</key>"
+              "</action>"
+            "</wish>"
+            "<wish gesture=\"Drag\" fingers=\"3\">"
+              "<action name=\"place\" when=\"update\">"
+                "<trigger prop=\"position x\" min=\"20\" max=\"80\" mode=\"accumulated\"/>"
+                "<key>Right</key>"
+              "</action>"
+            "</wish>"
+          "</application>"
+        "</applications>"
+      "</ginn>" }
+  };
 
+  Ginn::Wish::Table table = source_->get_wishes(raws);
+  ASSERT_EQ(table["dummy"].size(), 2u);
+  for (auto const& wish: table["dummy"])
+  {
+    if (wish.second->touches() == 2)
+      EXPECT_EQ(wish.second->trigger_mode(), Ginn::Wish::TriggerMode::accumulated);
+    else
+      EXPECT_EQ(wish.second->trigger_mode(), Ginn::Wish::TriggerMode::instantaneous);
+  }
+}